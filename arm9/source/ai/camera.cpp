@@ -111,6 +111,7 @@ void CenterBehindSubject(CameraState& camera) {
   CaptainState* captain = camera.game->RetrieveCaptain(camera.follow_captain);
   if (captain) {
       camera.target_angle = captain->entity->AngleTo(captain->cursor);
+      camera.game->renderer().CameraCut();
   }
 }
 
@@ -119,10 +120,12 @@ void IncrementZoomLevel(CameraState& camera) {
   if (camera.zoom_step > 2) {
     camera.zoom_step = 0;
   }
+  camera.game->renderer().CameraCut();
 }
 
 void ToggleHeightLevel(CameraState& camera) {
   camera.high_camera = !(camera.high_camera);
+  camera.game->renderer().CameraCut();
 }
 
 
@@ -27,6 +27,19 @@ const fixed kPikminThrowHeight = 1.8_f;
 const fixed kYellowPikminThrowHeight = 2.2_f;
 const int kWhistleExpandFrames = 8;
 
+void UpdateActiveOnion(CaptainState& captain) {
+  // Read straight from last tick's contacts rather than waiting for the beam's
+  // begin / end events, which only last one tick and could land on a step
+  // that doesn't look for them.
+  if (not captain.world().Senses(captain.body, ONION_BEAM_GROUP)) {
+    captain.active_onion = nullptr;
+    return;
+  }
+  auto beam = captain.world().FirstCollisionWith(captain.body, ONION_BEAM_GROUP);
+  captain.active_onion = beam.body ?
+      captain.game->RetrieveOnion(captain.world().Owner(beam.body)) : nullptr;
+}
+
 void HandleWhistle(CaptainState& captain) {
   captain.whistle_body->position = captain.cursor_body->position;
 
@@ -80,7 +93,7 @@ void InitAlways(CaptainState& captain) {
 
   captain.whistle_body->height = 20.0_f;
   captain.whistle_body->is_sensor = 1;
-  captain.whistle_body->owner = captain.handle;
+  captain.world().SetOwner(captain.whistle_body, captain.handle);
   captain.whistle_body->is_very_important = 1;
 }
 
@@ -141,14 +154,6 @@ void MoveCaptain(CaptainState& captain) {
   // Move the whistle to where the cursor is
   HandleWhistle(captain);
 
-  // Handle collision with certain kinds of sensors
-  if (captain.body->result_groups & ONION_BEAM_GROUP) {
-    onion_ai::OnionState* current_onion =
-        captain.game->RetrieveOnion(captain.body->FirstCollisionWith(ONION_BEAM_GROUP).body->owner);
-    captain.active_onion = current_onion;
-  } else {
-    captain.active_onion = nullptr;
-  }
   captain.game->DebugDictionary().Set("Pos: ", captain.position());
 
   // Play footsteps twice per animation:
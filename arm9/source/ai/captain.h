@@ -25,6 +25,10 @@ struct CaptainState : PikminGameState {
   onion_ai::OnionState* active_onion = nullptr;
 };
 
+// Points active_onion at the onion whose beam the captain is standing in, if
+// any. Run every step, before the state machine, so guards and the UI see it.
+void UpdateActiveOnion(CaptainState& captain);
+
 extern StateMachine<CaptainState> machine;
 
 }  // namespace captain_ai
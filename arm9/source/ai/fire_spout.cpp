@@ -24,37 +24,46 @@ void InitAlways(FireSpoutState& fire_spout) {
   // Setup our static physics properties
   fire_spout.body->collision_group = ATTACK_GROUP;
 
-  fire_spout.detection = fire_spout.world().AllocateBody(fire_spout.handle);
-  fire_spout.detection->position = fire_spout.position();
-  fire_spout.detection->radius = 10_f;
-  fire_spout.detection->height = 5_f;
-  fire_spout.detection->is_sensor = true;
-  fire_spout.detection->collision_group = DETECT_GROUP;
-
   auto health_state = fire_spout.game->RetrieveHealth(fire_spout.game->SpawnHealth());
   if (!health_state) {
     fire_spout.dead = true;
     return;
   }
   fire_spout.health_state = health_state;
-  fire_spout.body->owner = fire_spout.health_state->handle;
+  fire_spout.world().SetOwner(fire_spout.body, fire_spout.health_state->handle);
+
+  auto body_handle = fire_spout.world().HandleOf(fire_spout.body);
+  fire_spout.detection = fire_spout.world().AllocateTrigger(fire_spout.handle);
+  if (fire_spout.detection) {
+    fire_spout.detection->anchor = body_handle;
+    fire_spout.detection->radius = 10_f;
+    fire_spout.detection->height = 5_f;
+    fire_spout.detection->collision_group = DETECT_GROUP;
+  }
+
+  // The fire hazard only switches on while we're spouting flames
+  fire_spout.flame_sensor = fire_spout.world().AllocateTrigger(fire_spout.handle);
+  if (fire_spout.flame_sensor) {
+    fire_spout.flame_sensor->anchor = body_handle;
+    fire_spout.flame_sensor->radius = 2.0_f;
+    fire_spout.flame_sensor->collision_group = FIRE_HAZARD_GROUP;
+    fire_spout.flame_sensor->enabled = false;
+  }
 }
 
 void FlameOn(FireSpoutState& fire_spout) {
-  // Spawn in a physics entity for the fire hazard
-  fire_spout.flame_sensor = fire_spout.world().AllocateBody();
-  fire_spout.flame_sensor->radius = 2.0_f;
-  fire_spout.flame_sensor->is_sensor = true;
-  fire_spout.flame_sensor->collision_group = FIRE_HAZARD_GROUP;
-  fire_spout.flame_sensor->position = fire_spout.position();
+  if (fire_spout.flame_sensor) {
+    fire_spout.flame_sensor->enabled = true;
+  }
 
   //fire_spout.flame_timer = (rand() % 16) + 112;
   fire_spout.flame_timer = 128;
 }
 
 void FlameOff(FireSpoutState& fire_spout) {
-  fire_spout.world().FreeBody(fire_spout.flame_sensor);
-  fire_spout.flame_sensor = nullptr;
+  if (fire_spout.flame_sensor) {
+    fire_spout.flame_sensor->enabled = false;
+  }
 
   fire_spout.flame_timer = (rand() % 16) + 112;
 }
@@ -83,9 +92,8 @@ bool OutOfHealth(const FireSpoutState& fire_spout) {
 
 void KillSelf(FireSpoutState& fire_spout) {
   // If we presently have our hazard bubble up, kill it.
-  if (fire_spout.flame_sensor) {
-    FlameOff(fire_spout);
-  }
+  fire_spout.world().FreeTrigger(fire_spout.flame_sensor);
+  fire_spout.flame_sensor = nullptr;
 
   // TODO: Spawn a ring of gas particles to indicate death
   for (int i = 0; i < 16; i++) {
@@ -97,9 +105,9 @@ void KillSelf(FireSpoutState& fire_spout) {
   }
 
   // Clear out all of our collision data, so the pikmin stop attacking us
-  fire_spout.world().FreeBody(fire_spout.detection);
+  fire_spout.world().FreeTrigger(fire_spout.detection);
   fire_spout.detection = nullptr;
-  fire_spout.body->owner = Handle();
+  fire_spout.world().SetOwner(fire_spout.body, Handle());
 }
 
 Edge<FireSpoutState> init[] {
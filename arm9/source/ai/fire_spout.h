@@ -3,12 +3,13 @@
 
 #include "ai/health.h"
 #include "ai/pikmin_game_state.h"
+#include "physics/area_trigger.h"
 
 namespace fire_spout_ai {
 
 struct FireSpoutState : PikminGameState {
-  physics::Body* flame_sensor;
-  physics::Body* detection;
+  physics::AreaTrigger* flame_sensor{nullptr};
+  physics::AreaTrigger* detection{nullptr};
   int flame_timer{0};
   health_ai::HealthState* health_state;
 };
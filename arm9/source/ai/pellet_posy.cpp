@@ -13,12 +13,13 @@ namespace posy_ai {
 
 void InitAlways(PosyState& posy) {
   posy.entity->set_actor(posy.game->ActorAllocator()->Retrieve("pellet_posy"));
-  posy.detection = posy.world().AllocateBody(posy.handle);
-  posy.detection->position = posy.position();
-  posy.detection->radius = 10_f;
-  posy.detection->height = 5_f;
-  posy.detection->is_sensor = true;
-  posy.detection->collision_group = DETECT_GROUP;
+  posy.detection = posy.world().AllocateTrigger(posy.handle);
+  if (posy.detection) {
+    posy.detection->anchor = posy.world().HandleOf(posy.body);
+    posy.detection->radius = 10_f;
+    posy.detection->height = 5_f;
+    posy.detection->collision_group = DETECT_GROUP;
+  }
 
   posy.body->collision_group = ATTACK_GROUP;
 
@@ -31,7 +32,7 @@ void InitAlways(PosyState& posy) {
   posy.health_state->health = 25;
   posy.health_state->max_health = 25;
   posy.old_health = posy.health_state->health;
-  posy.body->owner = posy.health_state->handle;
+  posy.world().SetOwner(posy.body, posy.health_state->handle);
 }
 
 bool ZeroHealth(const PosyState& posy) {
@@ -47,7 +48,8 @@ void StoreCurrentHealth(PosyState& posy) {
 }
 
 void GoodbyeCruelWorld(PosyState& posy) {
-  posy.world().FreeBody(posy.detection);
+  posy.world().FreeTrigger(posy.detection);
+  posy.detection = nullptr;
   posy.dead = true;
 
   // Spawn in the pellet
@@ -56,8 +58,10 @@ void GoodbyeCruelWorld(PosyState& posy) {
 }
 
 void MarkAsDead(PosyState& posy) {
-  posy.body->owner = Handle();
-  posy.detection->owner = Handle();
+  posy.world().SetOwner(posy.body, Handle());
+  if (posy.detection) {
+    posy.detection->owner = Handle();
+  }
 }
 
 namespace PosyNode {
@@ -3,6 +3,7 @@
 
 #include "ai/health.h"
 #include "ai/pikmin_game_state.h"
+#include "physics/area_trigger.h"
 #include "physics/body.h"
 
 namespace posy_ai {
@@ -10,7 +11,7 @@ namespace posy_ai {
 struct PosyState : PikminGameState {
   health_ai::HealthState* health_state;
   unsigned int old_health;
-  physics::Body* detection;
+  physics::AreaTrigger* detection{nullptr};
 };
 
 extern StateMachine<PosyState> machine;
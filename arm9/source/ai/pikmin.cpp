@@ -194,7 +194,7 @@ bool TooFarFromTarget(const PikminState& pikmin) {
 
 bool CollidedWithWhistle(const PikminState& pikmin) {
   if (pikmin.current_squad == nullptr) {
-    if (pikmin.body->result_groups & WHISTLE_GROUP) {
+    if (pikmin.world().Senses(pikmin.body, WHISTLE_GROUP)) {
       return true;
     }
   }
@@ -202,11 +202,11 @@ bool CollidedWithWhistle(const PikminState& pikmin) {
 }
 
 void JoinSquad(PikminState& pikmin) {
-  auto result = pikmin.body->FirstCollisionWith(WHISTLE_GROUP);
+  auto result = pikmin.world().FirstCollisionWith(pikmin.body, WHISTLE_GROUP);
   // make sure we got a real result (this can fail in extreme cases)
   if (result.body) {
 
-    auto captain = pikmin.game->RetrieveCaptain(result.body->owner);
+    auto captain = pikmin.game->RetrieveCaptain(pikmin.world().Owner(result.body));
     if (captain) {
       pikmin.current_squad = &captain->squad;
       captain->squad.AddPikmin(&pikmin);
@@ -216,29 +216,30 @@ void JoinSquad(PikminState& pikmin) {
 
 bool ChaseTargetInvalid(const PikminState& pikmin) {
   // Some unspeakable horror caused our target to vanish or otherwise change
-  if (pikmin.world().RetrieveBody(pikmin.chase_target_body) == nullptr) {
+  auto chase_target = pikmin.world().RetrieveTrigger(pikmin.chase_target);
+  if (chase_target == nullptr or not chase_target->enabled) {
     return true;
   }
   return false;
 }
 
 bool CollideWithAttackable(const PikminState& pikmin) {
-  if (pikmin.body->result_groups & ATTACK_GROUP) {
+  if (pikmin.world().Senses(pikmin.body, ATTACK_GROUP)) {
     return true;
   }
   return false;
 }
 
 void SetAttackTarget(PikminState& pikmin) {
-  auto result = pikmin.body->FirstCollisionWith(ATTACK_GROUP);
+  auto result = pikmin.world().FirstCollisionWith(pikmin.body, ATTACK_GROUP);
   if (result.body) {
-    pikmin.attack_target_body = result.body->handle;
+    pikmin.attack_target_body = pikmin.world().HandleOf(result.body);
   }
   StopMoving(pikmin);
 }
 
 void ChaseTarget(PikminState& pikmin) {
-  if (Body* chase_target = pikmin.world().RetrieveBody(pikmin.chase_target_body)) {
+  if (auto chase_target = pikmin.world().RetrieveTrigger(pikmin.chase_target)) {
     pikmin.target = Vec2{chase_target->position.x, chase_target->position.z};
     RunToTarget(pikmin);
   }
@@ -246,7 +247,7 @@ void ChaseTarget(PikminState& pikmin) {
 
 void DealDamageToTarget(PikminState& pikmin) {
   if (Body* chase_target = pikmin.world().RetrieveBody(pikmin.attack_target_body)) {
-    if (HealthState* enemy_health = pikmin.game->RetrieveHealth(chase_target->owner)) {
+    if (HealthState* enemy_health = pikmin.game->RetrieveHealth(pikmin.world().Owner(chase_target))) {
       enemy_health->DealDamage(5);
     }
   }
@@ -262,19 +263,17 @@ bool CollideWithTarget(const PikminState& pikmin) {
   if (pikmin.current_squad) {
     return false;
   }
-  if (pikmin.body->result_groups & DETECT_GROUP) {
-    auto target_circle = pikmin.body->FirstCollisionWith(DETECT_GROUP);
-    if (target_circle.body) {
-      return true;
-    }
+  auto target_circle = pikmin.world().FirstCollisionWith(pikmin.body, DETECT_GROUP);
+  if (pikmin.world().RetrieveTrigger(target_circle.handle)) {
+    return true;
   }
   return false;
 }
 
 void StoreTargetBody(PikminState& pikmin) {
-  auto target_circle = pikmin.body->FirstCollisionWith(DETECT_GROUP);
-  if (target_circle.body) {
-    pikmin.chase_target_body = target_circle.body->handle;
+  auto target_circle = pikmin.world().FirstCollisionWith(pikmin.body, DETECT_GROUP);
+  if (pikmin.world().RetrieveTrigger(target_circle.handle)) {
+    pikmin.chase_target = target_circle.handle;
   }
 }
 
@@ -284,7 +283,7 @@ void Aim(PikminState& pikmin) {
 }
 
 bool CollideWithOnionFoot(const PikminState& pikmin) {
-  if (pikmin.body->result_groups & ONION_FEET_GROUP) {
+  if (pikmin.world().Senses(pikmin.body, ONION_FEET_GROUP)) {
     return true;
   }
   return false;
@@ -292,10 +291,10 @@ bool CollideWithOnionFoot(const PikminState& pikmin) {
 
 void StartClimbingOnion(PikminState& pikmin) {
   // Grab the onion / foot that we're targeting
-  auto onion_foot = pikmin.body->FirstCollisionWith(ONION_FEET_GROUP);
+  auto onion_foot = pikmin.world().FirstCollisionWith(pikmin.body, ONION_FEET_GROUP);
   fixed travel_frames = 60_f;
   if (onion_foot.body) {
-    auto onion = pikmin.game->RetrieveOnion(onion_foot.body->owner);
+    auto onion = pikmin.game->RetrieveOnion(pikmin.world().Owner(onion_foot.body));
     auto pikmin_body = pikmin.body;
     pikmin_body->position = onion_foot.body->position;
     pikmin_body->affected_by_gravity = false;
@@ -345,22 +344,20 @@ void HopOffFoot(PikminState& pikmin) {
 }
 
 bool CollideWithValidTreasure(const PikminState& pikmin) {
-  if (pikmin.body->result_groups & TREASURE_GROUP) {
-    auto treasure_result = pikmin.body->FirstCollisionWith(TREASURE_GROUP);
-    if (treasure_result.body != nullptr) {
-      auto treasure = pikmin.game->RetrieveTreasure(treasure_result.body->owner);
-      if (treasure->RoomForMorePikmin()) {
-        return true;
-      }
+  auto treasure_result = pikmin.world().FirstCollisionWith(pikmin.body, TREASURE_GROUP);
+  if (treasure_result.body != nullptr) {
+    auto treasure = pikmin.game->RetrieveTreasure(pikmin.world().Owner(treasure_result.body));
+    if (treasure->RoomForMorePikmin()) {
+      return true;
     }
   }
   return false;
 }
 
 void AddToTreasure(PikminState& pikmin) {
-  auto treasure_result = pikmin.body->FirstCollisionWith(TREASURE_GROUP);
+  auto treasure_result = pikmin.world().FirstCollisionWith(pikmin.body, TREASURE_GROUP);
   if (treasure_result.body != nullptr) {
-    pikmin.active_treasure = treasure_result.body->owner;
+    pikmin.active_treasure = pikmin.world().Owner(treasure_result.body);
     TreasureState* treasure = pikmin.game->RetrieveTreasure(pikmin.active_treasure);
     if (treasure) {
       treasure->AddPikmin(&pikmin);
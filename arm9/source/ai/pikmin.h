@@ -51,7 +51,7 @@ struct PikminState : PikminGameState {
 
   Handle active_treasure;
 
-  Handle chase_target_body;
+  Handle chase_target;  // Detection area we're running towards
 
   Handle attack_target_body;
 
@@ -8,6 +8,7 @@ Vec3 PikminGameState::position() const {
 
 void PikminGameState::set_position(Vec3 position) {
   body->position = position;
+  world().Wake(body);
 }
 
 Vec3 PikminGameState::velocity() const {
@@ -16,6 +17,7 @@ Vec3 PikminGameState::velocity() const {
 
 void PikminGameState::set_velocity(Vec3 velocity) {
   body->velocity = velocity;
+  world().Wake(body);
 }
 
 physics::World& PikminGameState::world() const {
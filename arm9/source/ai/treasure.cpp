@@ -16,22 +16,11 @@ using physics::Body;
 
 namespace treasure_ai {
 
-void TreasureState::UpdateDetectionBody() {
-  if (RoomForMorePikmin() and  !detection_active and carryable) {
-    detection = world().AllocateBody(handle);
-    detection->position = position();
-    detection->radius = 10_f;
-    detection->height = 5_f;
-    detection->is_sensor = true;
-    detection->collision_group = DETECT_GROUP;
-    detection_active = true;
-    return;
-  }
-  if (!RoomForMorePikmin() and detection_active) {
-    // Disable the detection radius so pikmin stop attempting to chase us
-    world().FreeBody(detection);
-    detection_active = false;
-    return;
+void TreasureState::UpdateDetection() {
+  // Disable the detection radius while we're full, so pikmin stop attempting
+  // to chase us
+  if (detection) {
+    detection->enabled = RoomForMorePikmin() and carryable;
   }
 }
 
@@ -42,7 +31,7 @@ bool TreasureState::AddPikmin(PikminState* pikmin) {
         active_pikmin[i] = pikmin;
         num_active_pikmin++;
         lift_timer = 0;
-        UpdateDetectionBody();
+        UpdateDetection();
         return true;
       }
     }
@@ -56,7 +45,7 @@ void TreasureState::RemovePikmin(PikminState* pikmin) {
       active_pikmin[i] = nullptr;
       num_active_pikmin--;
       lift_timer = 0;
-      UpdateDetectionBody();
+      UpdateDetection();
       return;
     }
   }
@@ -71,7 +60,14 @@ bool TreasureState::Moving() {
 }
 
 void Init(TreasureState& treasure) {
-  treasure.UpdateDetectionBody();
+  treasure.detection = treasure.world().AllocateTrigger(treasure.handle);
+  if (treasure.detection) {
+    treasure.detection->anchor = treasure.world().HandleOf(treasure.body);
+    treasure.detection->radius = 10_f;
+    treasure.detection->height = 5_f;
+    treasure.detection->collision_group = DETECT_GROUP;
+  }
+  treasure.UpdateDetection();
 
   treasure.body->collision_group = TREASURE_GROUP;
   treasure.body->affected_by_gravity = true;
@@ -151,9 +147,6 @@ void UpdatePikminPositions(TreasureState& treasure) {
 }
 
 void IdleAlways(TreasureState& treasure) {
-  if (treasure.detection_active) {
-    treasure.detection->position = treasure.position();
-  }
   UpdatePikminPositions(treasure);
   if (treasure.Moving()) {
     treasure.lift_timer++;
@@ -190,9 +183,6 @@ void MoveTowardTarget(TreasureState& treasure) {
   new_velocity.y = treasure.body->velocity.y;
   treasure.set_velocity(new_velocity);
   UpdatePikminPositions(treasure);
-  if (treasure.detection_active) {
-    treasure.detection->position = treasure.position();
-  }
 }
 
 bool DestinationReached(const TreasureState& treasure) {
@@ -206,10 +196,8 @@ void PrepareForRetrieval(TreasureState& treasure) {
   // Align with the destination region
   treasure.set_position(destination->position());
   // Kill the targeting radius, so pikmin stop trying to carry us
-  if (treasure.detection_active) {
-    treasure.world().FreeBody(treasure.detection);
-    treasure.detection = nullptr;
-  }
+  treasure.world().FreeTrigger(treasure.detection);
+  treasure.detection = nullptr;
   // Dislodge all the pikmin carrying us
   treasure.carryable = false;
   // Remove ourselves from physics calculations, and prepare to rise into the
@@ -2,6 +2,7 @@
 #define AI_TREASURE_H
 
 #include "ai/pikmin_game_state.h"
+#include "physics/area_trigger.h"
 #include "physics/body.h"
 #include "pikmin.h"
 
@@ -27,8 +28,7 @@ struct TreasureState : PikminGameState {
   pikmin_ai::PikminType pikmin_affinity{pikmin_ai::PikminType::kNone};
 
 
-  physics::Body* detection;
-  bool detection_active{false};
+  physics::AreaTrigger* detection{nullptr};
   pikmin_ai::PikminState* active_pikmin[100];
   int num_active_pikmin{0};
 
@@ -36,7 +36,7 @@ struct TreasureState : PikminGameState {
   void RemovePikmin(pikmin_ai::PikminState* pikmin);
   bool RoomForMorePikmin();
   bool Moving();
-  void UpdateDetectionBody();
+  void UpdateDetection();
 };
 
 extern StateMachine<TreasureState> machine;
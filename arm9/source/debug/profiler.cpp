@@ -21,6 +21,11 @@ void Profiler::ClearTopic(int topic_id) {
   topics_[topic_id].timing.end = 0;
 }
 
+void Profiler::RecordTopic(int topic_id, u32 ticks) {
+  topics_[topic_id].timing.start = 0;
+  topics_[topic_id].timing.end = ticks;
+}
+
 void Profiler::StartTimer() {
   cpuStartTiming(0);
 }
@@ -27,6 +27,8 @@ namespace Profiler {
 void StartTopic(int topic_id);
 void EndTopic(int topic_id);
 void ClearTopic(int topic_id);
+// For topics that aren't timed in one go; sets the topic's time directly.
+void RecordTopic(int topic_id, u32 ticks);
 
 void StartTimer();
 
@@ -2,8 +2,6 @@
 
 #include <cstdio>
 
-#include <nds/arm9/postest.h>
-
 namespace nt = numeric_types;
 
 using numeric_types::literals::operator"" _f;
@@ -82,6 +80,66 @@ void Drawable::SetCache() {
   cached_matrix_[10]  = cached_.position.x.data_;
   cached_matrix_[11] = cached_.position.y.data_;
   cached_matrix_[12] = cached_.position.z.data_;
+
+  drawn_mesh_ = cached_.current_mesh;
+  drawn_animation_ = cached_.animation;
+}
+
+void Drawable::SelectLod(fixed depth, fixed lod_distance, fixed impostor_distance) {
+  drawn_mesh_ = cached_.current_mesh;
+  drawn_animation_ = cached_.animation;
+  if (drawn_mesh_ == nullptr) {
+    return;
+  }
+
+  // Same eighth either side of the boundary as for the LODs below. The atlas
+  // only has poses from one animation, so anything else keeps its mesh.
+  impostor_ = drawn_mesh_->impostor != nullptr and
+      drawn_mesh_->impostor->atlas->animation == cached_.animation and
+      depth > (impostor_ ?
+      impostor_distance * 7_f / 8_f : impostor_distance * 9_f / 8_f);
+  if (impostor_) {
+    drawn_mesh_ = drawn_mesh_->impostor;
+    return;
+  }
+
+  // LOD n takes over at n * lod_distance; move up or down a level only once
+  // past that by an eighth, so entities sitting on a boundary don't flicker.
+  const u32 lod_count = drawn_mesh_->lod_count;
+  u32 lod = lod_ < lod_count ? lod_ : lod_count;
+  const fixed switch_up = lod_distance * 9_f / 8_f;
+  const fixed switch_down = lod_distance * 7_f / 8_f;
+  while (lod < lod_count and depth > switch_up * fixed::FromInt(lod + 1)) {
+    lod++;
+  }
+  while (lod > 0 and depth < switch_down * fixed::FromInt(lod)) {
+    lod--;
+  }
+  lod_ = lod;
+
+  // An animated entity can only use a LOD that has its animation too; fall
+  // back on the next more detailed one that does.
+  for (; lod > 0; lod--) {
+    if (cached_.animation == nullptr) {
+      drawn_mesh_ = drawn_mesh_->lods[lod - 1];
+      return;
+    }
+    Animation* animation = cached_.animation->lods[lod - 1];
+    if (animation != nullptr and
+        cached_.animation_frame < animation->frame_length) {
+      drawn_mesh_ = drawn_mesh_->lods[lod - 1];
+      drawn_animation_ = animation;
+      return;
+    }
+  }
+}
+
+Mesh* Drawable::DrawnMesh() {
+  return drawn_mesh_;
+}
+
+Animation* Drawable::DrawnAnimation() {
+  return drawn_animation_;
 }
 
 void Drawable::set_actor(Dsgx* actor) {
@@ -140,18 +198,28 @@ void Drawable::ApplyTransformation() {
 }
 
 void Drawable::Draw() {
-  if (cached_.actor == nullptr or cached_.current_mesh == nullptr) {
+  // Impostors aren't display lists; the renderer draws them itself.
+  if (cached_.actor == nullptr or drawn_mesh_ == nullptr or
+      drawn_mesh_->atlas != nullptr) {
     return;
   }
   ApplyTransformation();
 
-  // Apply animation.
-  if (cached_.animation) {
-    cached_.actor->ApplyAnimation(cached_.animation, cached_.animation_frame, cached_.current_mesh);
+  // Baked animations have a whole display list for the frame ready to go.
+  if (drawn_animation_ and drawn_animation_->baked_lists) {
+    glCallList(drawn_animation_->BakedList(cached_.animation_frame));
+    return;
+  }
+
+  // Apply animation, unless the display list already holds this frame; the
+  // renderer groups entities on the same frame together for this.
+  if (drawn_animation_ and (drawn_mesh_->applied_animation != drawn_animation_ or
+      drawn_mesh_->applied_frame != cached_.animation_frame)) {
+    cached_.actor->ApplyAnimation(drawn_animation_, cached_.animation_frame, drawn_mesh_);
   }
 
   // Draw the object using display lists.
-  glCallList(cached_.current_mesh->model_data);
+  glCallList(drawn_mesh_->model_data);
 
 }
 
@@ -166,40 +234,25 @@ void Drawable::Update() {
   }
 }
 
-bool Drawable::InsideViewFrustrum() {
-  // Determine if this object is in the view frustrum using a BOX_TEST
-  glPushMatrix();
-  ApplyTransformation();
-  auto radius = cached_.current_mesh->bounding_radius;
-  glScalef32(radius.data_, radius.data_, radius.data_);
-
-  bool result = BoxTest(
-      (-1_f).data_,
-      (-1_f).data_,
-      (-1_f).data_,
-      (2_f).data_,
-      (2_f).data_,
-      (2_f).data_);
-
-  glPopMatrix(1);
-
-  return result;
-}
-
-numeric_types::fixed Drawable::GetRealModelZ() {
-  // Avoid clobbering the render state for this poll by pushing the current
-  // matrix before performing the position test.
-  glPushMatrix();
-  ApplyTransformation();
-
-  // Perform a hardware position test on the center of the model.
-  Vec3& center = cached_.current_mesh->bounding_center;
-  PosTest(center.x.data_, center.y.data_, center.z.data_);
-  numeric_types::fixed result;
-  result.data_ = PosTestZresult();
+void Drawable::BoundingSphere(Vec3& center, fixed& radius) {
+  const Mesh* mesh = cached_.current_mesh;
+  if (cached_.rotation.x.data_ or cached_.rotation.z.data_) {
+    // Rare enough not to bother rotating the center about every axis; grow the
+    // sphere to cover anywhere the rotation could have put it instead.
+    center = cached_.position;
+    radius = (mesh->bounding_center.Length() + mesh->bounding_radius) * cached_.scale;
+    return;
+  }
 
-  glPopMatrix(1);
-  return result;
+  // Rotate the center the same way cached_matrix_ does.
+  const fixed sine = trig::SinLerp(cached_.rotation.y);
+  const fixed cosine = trig::CosLerp(cached_.rotation.y);
+  const Vec3 local = mesh->bounding_center * cached_.scale;
+  center = cached_.position + Vec3{
+    local.x * cosine + local.z * sine,
+    local.y,
+    local.z * cosine - local.x * sine};
+  radius = mesh->bounding_radius * cached_.scale;
 }
 
 void Drawable::SetAnimation(std::string name) {
@@ -47,7 +47,21 @@ class Drawable {
   void RotateToFace(numeric_types::Brads target_angle, numeric_types::Brads rate = numeric_types::Brads::Raw(degreesToAngle(180)));
   void RotateToFace(const Drawable* destination, numeric_types::Brads rate = numeric_types::Brads::Raw(degreesToAngle(180)));
 
-  bool InsideViewFrustrum();
+  // Where the cached state puts the mesh's bounding sphere, in world space.
+  void BoundingSphere(Vec3& center, numeric_types::fixed& radius);
+
+  // Picks which of the cached mesh's LODs to draw this frame, given how far
+  // in front of the camera it is, and how much further out each successive
+  // LOD should take over. Past impostor_distance, a mesh that has an impostor
+  // uses that instead, if the entity is playing the animation its atlas was
+  // rendered from. Until this is called, the full mesh is drawn.
+  void SelectLod(numeric_types::fixed depth, numeric_types::fixed lod_distance,
+      numeric_types::fixed impostor_distance);
+  // The mesh Draw will actually send; the cached mesh, one of its LODs, or
+  // its impostor, which Draw leaves to the renderer.
+  Mesh* DrawnMesh();
+  // The animation Draw applies to DrawnMesh, if any.
+  Animation* DrawnAnimation();
 
   void set_actor(Dsgx* actor);
   Dsgx* actor();
@@ -58,20 +72,27 @@ class Drawable {
   inline void ApplyTransformation();
   void Draw();
 
-  numeric_types::fixed GetRealModelZ();
-
   void SetAnimation(std::string name);
   u32 CurrentFrame();
 
   bool important{true};
   unsigned int overlaps{0};
   bool visible{false};
+  // Where the renderer sorted this last time it was drawn.
+  unsigned int draw_order{~0u};
 
  private:
   DrawState current_{};
   DrawState cached_{};
 
   s32 cached_matrix_[13]; //one extra entry for size; for DMA transfers
+
+  // Kept between frames, so SelectLod only switches once an entity is well
+  // past the boundary.
+  unsigned int lod_{0};
+  bool impostor_{false};
+  Mesh* drawn_mesh_{nullptr};
+  Animation* drawn_animation_{nullptr};
 };
 
 #endif  // DRAWABLE_ENTITY_H
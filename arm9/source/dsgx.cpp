@@ -1,10 +1,13 @@
 #include "dsgx.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <string>
 
 #include "debug/messages.h"
 #include "debug/utilities.h"
+#include "dsgx_allocator.h"
+#include "project_settings.h"
 
 using namespace std;
 namespace nt = numeric_types;
@@ -12,6 +15,73 @@ using nt::literals::operator"" _f;
 
 constexpr u32 kChunkHeaderSizeWords{2};
 
+namespace {
+
+// Sorts the runs from first on by where they go, so the display list is
+// written front to back, and merges any that carry on from one another. If any
+// two runs write over each other, which one wins depends on their order, so
+// those are left as they were and only merged where they already line up.
+void MergeRuns(std::vector<CopyRun>& runs, size_t first) {
+  const std::vector<CopyRun> unsorted(runs.begin() + first, runs.end());
+  std::stable_sort(runs.begin() + first, runs.end(),
+      [](const CopyRun& a, const CopyRun& b) {
+        return a.destination < b.destination;
+      });
+  for (size_t i = first + 1; i < runs.size(); i++) {
+    if (runs[i].destination < runs[i - 1].destination + runs[i - 1].count) {
+      std::copy(unsorted.begin(), unsorted.end(), runs.begin() + first);
+      break;
+    }
+  }
+  size_t last = first;
+  for (size_t i = first + 1; i < runs.size(); i++) {
+    CopyRun& previous = runs[last];
+    const CopyRun& run = runs[i];
+    if (run.destination == previous.destination + previous.count and
+        run.source == previous.source + previous.count) {
+      previous.count += run.count;
+    } else {
+      runs[++last] = run;
+    }
+  }
+  if (runs.size() > first) {
+    runs.resize(last + 1);
+  }
+}
+
+void RunCopyProgram(const CopyRun* run, const CopyRun* end, const u32* source,
+    u32* destination) {
+  // Blocks of four words, which the compiler can move with a single ldm/stm
+  // pair.
+  struct Block {
+    u32 words[4];
+  };
+  for (; run < end; run++) {
+    u32* to = destination + run->destination;
+    const u32* from = source + run->source;
+    u32 count = run->count;
+    for (; count >= 4; count -= 4) {
+      *((Block*)to) = *((const Block*)from);
+      to += 4;
+      from += 4;
+    }
+    for (; count > 0; count--) {
+      *to++ = *from++;
+    }
+  }
+}
+
+// TEXTURE_SIZE_* for a dimension in texels; 8 << size.
+int TextureSizeFor(int texels) {
+  int size = 0;
+  while ((8 << size) < texels) {
+    size++;
+  }
+  return size;
+}
+
+}  // namespace
+
 Dsgx::Dsgx(u32* data, const u32 length):
     meshes_{},
     bone_animations_{} {
@@ -23,6 +93,8 @@ Dsgx::Dsgx(u32* data, const u32 length):
 
   // Nice-ify the animation data
   CollectAnimations();
+  LinkLods();
+  CompileCopyPrograms();
 
   // Print out a crapton of debug info
   //debug::Log("== DSGX Data ==");
@@ -250,6 +322,26 @@ void Dsgx::AnimChunk(u32* data) {
   //debug::nocashValue("Word Count", anim.word_count);
 }
 
+void Dsgx::LinkLods() {
+  for (auto& kv : meshes_) {
+    Mesh& mesh = kv.second;
+    for (u32 level = 1; level <= kMaxMeshLods; level++) {
+      Mesh* lod = MeshByName((kv.first + "_lod" + std::to_string(level)).c_str());
+      if (lod == nullptr) {
+        continue;
+      }
+      // Gaps in the numbering are skipped, so lods[] stays packed.
+      for (auto& animation : mesh.animations) {
+        auto lod_animation = lod->animations.find(animation.first);
+        if (lod_animation != lod->animations.end()) {
+          animation.second.lods[mesh.lod_count] = &lod_animation->second;
+        }
+      }
+      mesh.lods[mesh.lod_count++] = lod;
+    }
+  }
+}
+
 Mesh* Dsgx::MeshByName(const char* mesh_name) {
   if (meshes_.count(mesh_name) > 0) {
     return &meshes_[mesh_name];
@@ -276,31 +368,109 @@ Animation* Dsgx::GetAnimation(string name, Mesh* mesh) {
 }
 
 void Dsgx::ApplyAnimation(Animation* animation, u32 frame, Mesh* mesh) {
-  auto destination = mesh->model_data + 1;
-  for (auto& channel : animation->channels) {
-    auto& ref = channel.first;
-    auto& data = channel.second;
-    u32 const* current_data = data.data;
-    current_data += ref.num_references * data.word_count * frame;
-    if (data.word_count == 1) {
-      //Optimized Case for 1-word copies, avoids the inner loop
-      for (auto offset_list = ref.offset_lists.begin(); offset_list != ref.offset_lists.end(); offset_list++) {
-        for (u32 i = 0; i < offset_list->num_offsets; i++) {
-            *((u32*)(destination + offset_list->offsets[i])) = *current_data;
+  PatchAnimation(animation, frame, mesh->model_data + 1);
+  mesh->applied_animation = animation;
+  mesh->applied_frame = frame;
+}
+
+void Dsgx::CompileCopyPrograms() {
+  for (auto& m : meshes_) {
+    Mesh& mesh = m.second;
+    for (auto& a : mesh.animations) {
+      Animation& animation = a.second;
+      animation.program.clear();
+      animation.runs.clear();
+      for (auto& channel : animation.channels) {
+        const AnimationReference& ref = channel.first;
+        const AnimationData& data = channel.second;
+        const size_t first = animation.runs.size();
+        u32 source = 0;
+        for (auto& offset_list : ref.offset_lists) {
+          for (u32 i = 0; i < offset_list.num_offsets; i++) {
+            animation.runs.push_back(
+                CopyRun{offset_list.offsets[i], source, data.word_count});
+          }
+          source += data.word_count;
         }
-        current_data++;
+        MergeRuns(animation.runs, first);
+        animation.program.push_back(CopyChannel{data.data,
+            ref.num_references * data.word_count,
+            (u32)(animation.runs.size() - first)});
       }
-    } else {
-      for (auto offset_list = ref.offset_lists.begin(); offset_list != ref.offset_lists.end(); offset_list++) {
-        for (u32 i = 0; i < offset_list->num_offsets; i++) {
-          for (u32 d = 0; d < data.word_count; d++) {
-            *((u32*)(destination + offset_list->offsets[i] + d)) = current_data[d];
-          }
+    }
+
+    mesh.bone_runs.clear();
+    const u32 matrix_words = sizeof(m4x4) / sizeof(u32);
+    u32 source = 0;
+    for (auto& bone : mesh.bones) {
+      for (u32 i = 0; i < bone.num_offsets; i++) {
+        mesh.bone_runs.push_back(
+            CopyRun{bone.offsets[i], source, matrix_words});
+      }
+      source += matrix_words;
+    }
+    MergeRuns(mesh.bone_runs, 0);
+  }
+}
+
+void Dsgx::PatchAnimation(Animation* animation, u32 frame, u32* destination) {
+  const CopyRun* run = animation->runs.data();
+  for (auto& channel : animation->program) {
+    const CopyRun* end = run + channel.run_count;
+    RunCopyProgram(run, end, channel.data + channel.frame_words * frame,
+        destination);
+    run = end;
+  }
+}
+
+u32* Animation::BakedList(u32 frame) const {
+  if (baked_lists == nullptr) {
+    return nullptr;
+  }
+  return baked_lists + frame / baked_step * baked_list_words;
+}
+
+u32 Dsgx::BakeAnimations(DsgxAllocator* allocator, u32 frame_step) {
+  u32 baked_bytes = 0;
+  for (auto& m : meshes_) {
+    Mesh& mesh = m.second;
+    // The first word is the list's length, not counting itself.
+    const u32 list_words = mesh.model_data[0] + 1;
+    for (auto& a : mesh.animations) {
+      Animation& animation = a.second;
+      const u32 lists = (animation.frame_length + frame_step - 1) / frame_step;
+      u32* baked = (u32*)allocator->Allocate(lists * list_words * sizeof(u32));
+      if (baked == nullptr) {
+        debug::Log("Couldn't bake " + m.first + ": " + a.first);
+        continue;
+      }
+      for (u32 i = 0; i < lists; i++) {
+        u32* list = baked + i * list_words;
+        for (u32 word = 0; word < list_words; word++) {
+          list[word] = mesh.model_data[word];
         }
-        current_data += data.word_count;
+        PatchAnimation(&animation, i * frame_step, list + 1);
       }
+      animation.baked_lists = baked;
+      animation.baked_list_words = list_words;
+      animation.baked_step = frame_step;
+      baked_bytes += lists * list_words * sizeof(u32);
+    }
+  }
+  return baked_bytes;
+}
+
+u32 Dsgx::BakedBytes(u32 frame_step) {
+  u32 baked_bytes = 0;
+  for (auto& m : meshes_) {
+    Mesh& mesh = m.second;
+    const u32 list_words = mesh.model_data[0] + 1;
+    for (auto& a : mesh.animations) {
+      const u32 lists = (a.second.frame_length + frame_step - 1) / frame_step;
+      baked_bytes += lists * list_words * sizeof(u32);
     }
   }
+  return baked_bytes;
 }
 
 BoneAnimation* Dsgx::GetBoneAnimation(string name) {
@@ -313,14 +483,11 @@ BoneAnimation* Dsgx::GetBoneAnimation(string name) {
 }
 
 void Dsgx::ApplyBoneAnimation(BoneAnimation* animation, u32 frame, Mesh* mesh) {
-  auto destination = mesh->model_data + 1;
-  m4x4 const* current_matrix = animation->transforms + mesh->bones.size() * frame;
-  for (auto bone = mesh->bones.begin(); bone != mesh->bones.end(); bone++) {
-    for (u32 i = 0; i < bone->num_offsets; i++) {
-      *((m4x4*)(destination + bone->offsets[i])) = *current_matrix;
-    }
-    current_matrix++;
-  }
+  mesh->applied_animation = nullptr;
+  const m4x4* frame_matrices = animation->transforms + mesh->bones.size() * frame;
+  RunCopyProgram(mesh->bone_runs.data(),
+      mesh->bone_runs.data() + mesh->bone_runs.size(),
+      (const u32*)frame_matrices, mesh->model_data + 1);
 }
 
 void Dsgx::ApplyTextures(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator) {
@@ -332,7 +499,7 @@ void Dsgx::ApplyTextures(VramAllocator<Texture>* texture_allocator, VramAllocato
     for (auto texture = mesh->textures.begin(); texture != mesh->textures.end(); texture++) {
       auto loaded_texture = texture_allocator->Retrieve(texture->name);
       // First, write the offset to actual TEXEL data; we always need to do this
-      u32 location = (u32)loaded_texture.offset;
+      u32 location = (u32)(uintptr_t)loaded_texture.offset;
       location /= 8;
       for (u32 i = 0; i < texture->num_offsets; i++) {
         //set the texture offset
@@ -350,7 +517,7 @@ void Dsgx::ApplyTextures(VramAllocator<Texture>* texture_allocator, VramAllocato
       // also write in the PALETTE BASE data; this is a little funky
       if (loaded_texture.format != GL_RGBA) {
         auto loaded_palette = palette_allocator->Retrieve(texture->name);
-        u32 palette_location = (u32)loaded_palette.offset - (u32)palette_allocator->Base();
+        u32 palette_location = (u32)((uintptr_t)loaded_palette.offset - (uintptr_t)palette_allocator->Base());
         // if this is a 4bpp texture (format 2) we use 8-byte offsets
         // otherwise we use 16 byte offsets
         if (loaded_texture.format == GL_RGB4) {
@@ -367,3 +534,30 @@ void Dsgx::ApplyTextures(VramAllocator<Texture>* texture_allocator, VramAllocato
     }
   }
 }
+
+void Dsgx::ApplyImpostors(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator) {
+  for (auto& m : meshes_) {
+    const string texture_name = m.first + "_impostor.a3i5";
+    if (not texture_allocator->Contains(texture_name)) {
+      continue;
+    }
+    ImpostorAtlas& atlas = atlases_[m.first];
+    atlas.texture = texture_allocator->Retrieve(texture_name);
+    atlas.texture.format_width =
+        TextureSizeFor(IMPOSTOR_ANGLES * IMPOSTOR_CELL_SIZE);
+    atlas.texture.format_height =
+        TextureSizeFor(IMPOSTOR_FRAMES * IMPOSTOR_CELL_SIZE);
+    atlas.palette = palette_allocator->Retrieve(texture_name);
+    auto animation = m.second.animations.find(IMPOSTOR_ANIMATION);
+    atlas.animation = animation != m.second.animations.end() ?
+        &animation->second : nullptr;
+
+    Mesh& impostor = impostors_[m.first];
+    impostor.name = m.second.name;
+    impostor.bounding_center = m.second.bounding_center;
+    impostor.bounding_radius = m.second.bounding_radius;
+    impostor.draw_cost = 1;
+    impostor.atlas = &atlas;
+    m.second.impostor = &impostor;
+  }
+}
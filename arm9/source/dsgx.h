@@ -33,10 +33,47 @@ struct AnimationData {
   u32* data;
 };
 
+// One stretch of words for ApplyAnimation to copy: count words from source,
+// counted from the start of the frame's data, to destination, counted from
+// the first word after the display list's length.
+struct CopyRun {
+  u32 destination;
+  u32 source;
+  u32 count;
+};
+
+// The runs that copy one channel's frames, and where those frames are.
+struct CopyChannel {
+  const u32* data;
+  u32 frame_words;
+  u32 run_count;
+};
+
+// Lower detail meshes are exported alongside the full one, named after it
+// with a "_lod1", "_lod2"... suffix, each with its own COST and animations.
+constexpr u32 kMaxMeshLods = 3;
+
 struct Animation {
   char* name;
   u32 frame_length;
   std::vector<std::pair<AnimationReference, AnimationData>> channels;
+  // The channels compiled into flat runs of words to copy, one channel after
+  // another, with neighbouring words that go to neighbouring places merged.
+  // This is what ApplyAnimation actually follows.
+  std::vector<CopyChannel> program;
+  std::vector<CopyRun> runs;
+  // The same animation on each of the mesh's LODs, or nullptr where that LOD
+  // doesn't have it.
+  Animation* lods[kMaxMeshLods] = {};
+
+  // Complete display lists for every baked_step'th frame, one after another,
+  // baked_list_words apart, if Dsgx::BakeAnimations has been run; nullptr
+  // otherwise.
+  u32* baked_lists{nullptr};
+  u32 baked_list_words{0};
+  u32 baked_step{0};
+  // The display list to draw for this frame, or nullptr if not baked.
+  u32* BakedList(u32 frame) const;
 };
 
 struct BoneReference {
@@ -56,6 +93,17 @@ struct TextureParam {
   u32* offsets;
 };
 
+// A pre-rendered atlas of views of a mesh, for drawing it far away as a single
+// quad. Built by tools/blender2impostor.py and loaded as a texture named
+// "<mesh>_impostor.a3i5"; see render::Impostors for the layout.
+struct ImpostorAtlas {
+  Texture texture;
+  TexturePalette palette;
+  // The mesh's IMPOSTOR_ANIMATION, which the rows were rendered from, or
+  // nullptr if it has no such animation.
+  Animation* animation{nullptr};
+};
+
 struct Mesh {
   char* name;
   template <typename FixedT, int FixedF>
@@ -64,8 +112,29 @@ struct Mesh {
   Vec3 bounding_center;
   Fixed<s32, 12> bounding_radius;
   u32 draw_cost{0};
+  // Filled in at runtime by render::PolygonBudget, from the polygon RAM this
+  // mesh was seen to use; 0 until it's been measured.
+  u16 measured_cost{0};
+  u32 cost_sampled_pass{0};
+
+  // Progressively cheaper versions of this mesh, coarsest last.
+  Mesh* lods[kMaxMeshLods] = {};
+  u32 lod_count{0};
+  // Stands in for this mesh far from the camera, or nullptr if there's no
+  // atlas for it. An impostor has a draw_cost of one quad, no model_data, and
+  // an atlas; nothing else is set.
+  Mesh* impostor{nullptr};
+  const ImpostorAtlas* atlas{nullptr};
+
+  // What ApplyAnimation last wrote into model_data, so drawing the same frame
+  // again can skip it. applied_animation is nullptr when unknown.
+  Animation* applied_animation{nullptr};
+  u32 applied_frame{0};
 
   std::vector<BoneReference> bones;
+  // Copies each bone's matrix for a frame to wherever it's used, in the same
+  // form as Animation::runs. Every bone animation shares it.
+  std::vector<CopyRun> bone_runs;
   std::vector<TextureParam> textures;
 
   std::map<std::string, Animation> animations;
@@ -75,6 +144,8 @@ struct Mesh {
 
 // Represents the contents of a .dsgx file.
 // Dsgx parses .dsgx contents and provides accessors for its content.
+class DsgxAllocator;
+
 class Dsgx {
  public:
   template <typename FixedT, int FixedF>
@@ -90,6 +161,17 @@ class Dsgx {
   void ApplyAnimation(Animation* animation, u32 frame, Mesh* mesh);
   void ApplyBoneAnimation(BoneAnimation* animation, u32 frame, Mesh* mesh);
   void ApplyTextures(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator);
+  // Gives every mesh with a loaded impostor atlas its impostor.
+  void ApplyImpostors(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator);
+  // Pre-applies every frame_step'th frame of every animation to its own copy
+  // of the display list, so drawing never has to patch one; an entity on a
+  // frame in between draws the one before. Trades memory (from allocator) for
+  // CPU time; see host/tools/dsgx_info for the numbers. Run after
+  // ApplyTextures, since the copies keep the texture offsets as they stand.
+  // Returns the bytes used; animations that don't fit are left unbaked.
+  u32 BakeAnimations(DsgxAllocator* allocator, u32 frame_step);
+  // Bytes BakeAnimations would use at this step, if everything fit.
+  u32 BakedBytes(u32 frame_step);
 
 private:
   u32 ProcessChunk(u32* location);
@@ -102,9 +184,14 @@ private:
   void ArefChunk(u32* data);
   void AnimChunk(u32* data);
   void CollectAnimations();
+  void LinkLods();
+  void CompileCopyPrograms();
+  void PatchAnimation(Animation* animation, u32 frame, u32* destination);
 
   std::map<std::string, Mesh> meshes_;
   std::map<std::string, BoneAnimation> bone_animations_;
+  std::map<std::string, Mesh> impostors_;
+  std::map<std::string, ImpostorAtlas> atlases_;
 
   std::vector<AnimationReference> animation_references_;
   std::vector<AnimationData> animation_data_;
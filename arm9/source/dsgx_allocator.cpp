@@ -29,11 +29,11 @@ Dsgx* DsgxAllocator::Load(string name, const u8* data, u32 size) {
   if (next_element_ + size / sizeof(u8) > end_) {
     debug::Log("Not enough room for:");
     debug::Log(name.c_str());
-    debug::Log("next element was: " + std::to_string((int)next_element_));
+    debug::Log("next element was: " + std::to_string((uintptr_t)next_element_));
     //debug::nocashNumber((int)next_element_);
     debug::Log("size was: " + std::to_string((int)size));
     //debug::nocashNumber((int)size);
-    debug::Log("end was: " + std::to_string((int)end_));
+    debug::Log("end was: " + std::to_string((uintptr_t)end_));
     //debug::nocashNumber((int)end_);
     return nullptr; // we don't have enough room for this object! and there was
               // panic. much panic.
@@ -55,6 +55,16 @@ Dsgx* DsgxAllocator::Load(string name, const u8* data, u32 size) {
   return loaded_assets[name];
 }
 
+u8* DsgxAllocator::Allocate(u32 size) {
+  u8* destination = (u8*)(((uintptr_t)next_element_ + 3) & ~(uintptr_t)3);
+  if (destination + size > end_) {
+    debug::Log("Not enough room for " + std::to_string((int)size) + " bytes");
+    return nullptr;
+  }
+  next_element_ = destination + size;
+  return destination;
+}
+
 Dsgx* DsgxAllocator::Retrieve(std::string name) {
   if (loaded_assets.count(name) > 0) {
     return loaded_assets[name];
@@ -15,6 +15,9 @@ class DsgxAllocator {
     ~DsgxAllocator();
     Dsgx* Load(std::string name, const u8* data, u32 size);
     Dsgx* Retrieve(std::string name);
+    // Raw, word aligned space from the same pool, for data derived from a
+    // loaded Dsgx; freed along with it by Reset. nullptr if there's no room.
+    u8* Allocate(u32 size);
     void Reset();
     int Used();
     int Free();
@@ -0,0 +1,114 @@
+#include "frame_scheduler.h"
+
+#include <nds.h>
+
+#include "debug/profiler.h"
+
+namespace {
+
+// 355 dots per scanline, 6 bus clock ticks per dot.
+constexpr u32 kTicksPerScanline = 355 * 6;
+constexpr int kVBlankStart = 192;
+constexpr int kScanlines = 263;
+// Don't cut it any finer than this; missing VBlank costs a whole frame.
+constexpr u32 kMargin = 2 * kTicksPerScanline;
+// Until a slice has been timed, assume it could take a quarter of a frame.
+constexpr u32 kUntimedEstimate = kScanlines / 4 * kTicksPerScanline;
+
+}  // namespace
+
+void FrameScheduler::AddSlice(int step, std::function<void()> run) {
+  if (slice_count_ >= kMaxSlices or step < 0 or step >= kMaxSteps) {
+    return;
+  }
+  slices_[slice_count_].step = step;
+  slices_[slice_count_].run = run;
+  slice_count_++;
+  if (step >= step_count_) {
+    step_count_ = step + 1;
+  }
+}
+
+void FrameScheduler::SetStepTopic(int step, int topic) {
+  if (step >= 0 and step < kMaxSteps) {
+    step_topics_[step] = topic;
+  }
+}
+
+int FrameScheduler::NextSlice() const {
+  for (int i = cursor_; i < slice_count_; i++) {
+    if (slices_[i].step == current_step_) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void FrameScheduler::RunSlice(Slice& slice) {
+  const u32 start = cpuGetTiming();
+  slice.run();
+  const u32 elapsed = cpuGetTiming() - start;
+  step_ticks_ += elapsed;
+  // Take a new worst case right away, but forget old ones only slowly; an
+  // overestimate just means the slice waits for Step.
+  if (elapsed > slice.estimate) {
+    slice.estimate = elapsed;
+  } else {
+    slice.estimate -= (slice.estimate - elapsed) / 8;
+  }
+}
+
+void FrameScheduler::Step() {
+  for (int next = NextSlice(); next >= 0; next = NextSlice()) {
+    cursor_ = next + 1;
+    RunSlice(slices_[next]);
+  }
+  if (step_topics_[current_step_] >= 0) {
+    debug::Profiler::RecordTopic(step_topics_[current_step_], step_ticks_);
+  }
+  step_ticks_ = 0;
+  if (step_count_ > 0) {
+    current_step_ = (current_step_ + 1) % step_count_;
+  }
+  cursor_ = 0;
+}
+
+void FrameScheduler::RunUntilVBlank() {
+  for (int next = NextSlice(); next >= 0; next = NextSlice()) {
+    Slice& slice = slices_[next];
+    const u32 estimate = slice.estimate ? slice.estimate : kUntimedEstimate;
+    if (estimate + kMargin > TicksUntilVBlank()) {
+      return;
+    }
+    cursor_ = next + 1;
+    RunSlice(slice);
+  }
+}
+
+u32 FrameScheduler::TicksUntilVBlank() {
+  const int line = REG_VCOUNT;
+  if (line == kVBlankStart) {
+    return 0;
+  }
+  // Past the start of VBlank, the wait is for the next one.
+  int lines = kVBlankStart - line;
+  if (lines < 0) {
+    lines += kScanlines;
+  }
+  return lines * kTicksPerScanline;
+}
+
+void FrameScheduler::WaitForVBlank() {
+  // Forget any VBlank that happened before now, so the BIOS waits for the
+  // next one. Interrupts stay off while checking, so one can't slip in
+  // between reading VCOUNT and clearing the flag and be lost; if it's due,
+  // it fires as soon as they're back on, and the wait returns right away.
+  REG_IME = 0;
+  const bool vblank_started = REG_VCOUNT == kVBlankStart;
+  INTR_WAIT_FLAGS &= ~IRQ_VBLANK;
+  REG_IME = 1;
+  if (vblank_started) {
+    return;
+  }
+  swiIntrWait(0, IRQ_VBLANK);
+}
@@ -0,0 +1,57 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <functional>
+
+#include <nds/ndstypes.h>
+
+// Runs the game's per-loop work (AI on one step, physics on the next) in
+// small slices, so that the renderer can get a head start on the next step
+// while it would otherwise sit waiting for VBlank. Whatever isn't done early
+// is finished by Step, so the game advances exactly as if every step had run
+// all at once; it just starts sooner.
+//
+// Each slice keeps an estimate of how long it takes, and is only started
+// early if that estimate fits comfortably before VBlank.
+class FrameScheduler {
+ public:
+  static const int kMaxSteps = 2;
+  static const int kMaxSlices = 16;
+
+  // Adds a slice to the end of a step. Steps take turns, starting with 0.
+  void AddSlice(int step, std::function<void()> run);
+  // Profiler topic to report each step's total time under, once it finishes.
+  // A step's slices can be spread over two loops, which a single start and
+  // end time can't cover.
+  void SetStepTopic(int step, int topic);
+
+  // Finishes the current step, then makes the following one current.
+  void Step();
+  // Runs slices of the current step for as long as they'll fit before VBlank.
+  void RunUntilVBlank();
+  // Sleeps until VBlank starts. Returns right away if it just has.
+  static void WaitForVBlank();
+
+ private:
+  struct Slice {
+    int step{0};
+    std::function<void()> run;
+    // Bus clock ticks; 0 until the slice has been timed once.
+    u32 estimate{0};
+  };
+
+  // Index of the next slice of the current step still to run, or -1.
+  int NextSlice() const;
+  void RunSlice(Slice& slice);
+  static u32 TicksUntilVBlank();
+
+  Slice slices_[kMaxSlices];
+  int slice_count_{0};
+  int step_count_{0};
+  int current_step_{0};
+  int cursor_{0};
+  int step_topics_[kMaxSteps] = {-1, -1};
+  u32 step_ticks_{0};
+};
+
+#endif  // FRAME_SCHEDULER_H
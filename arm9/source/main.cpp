@@ -14,6 +14,7 @@
 #include "level_loader.h"
 #include "particle_library.h"
 #include "pikmin_game.h"
+#include "project_settings.h"
 
 using captain_ai::CaptainState;
 
@@ -130,6 +131,12 @@ set<string> texture_extension_is_transparent {
   "t4bpp",
 };
 
+// Actors with enough copies on screen that their animations are worth baking
+// into whole display lists; see Dsgx::BakeAnimations.
+set<string> actors_with_baked_animations {
+  "pikmin",
+};
+
 template<typename T>
 void LoadFileWithMetadata(T* vram_allocator, typename T::Metadata metadata, string filename, string identifier) {
   vector<char> buffer = LoadEntireFile("/textures/" + filename);
@@ -182,8 +189,35 @@ void LoadActors(PikminGame& game) {
       LoadDsgxFile(game.ActorAllocator(), filename, BaseName(filename));
       // apply texture offsets from our previously loaded textures and palettes
       Dsgx* actor = game.ActorAllocator()->Retrieve(BaseName(filename));
+      if (actor == nullptr) {
+        continue;  // Didn't fit; Retrieve has already complained
+      }
       actor->ApplyTextures(game.TextureAllocator(), game.TexturePaletteAllocator());
+      actor->ApplyImpostors(game.TextureAllocator(), game.TexturePaletteAllocator());
+    }
+  }
+}
+
+// Baked display lists are big, so they only get whatever the actor pool has
+// left once every actor is in, at the finest step that fits.
+void BakeActorAnimations(PikminGame& game) {
+  DsgxAllocator* allocator = game.ActorAllocator();
+  for (const string& name : actors_with_baked_animations) {
+    Dsgx* actor = allocator->Retrieve(name);
+    if (actor == nullptr) {
+      continue;
+    }
+    u32 step = BAKED_ANIMATION_STEP;
+    // (Plus a word, for the allocator lining the lists up.)
+    while (step <= MAX_BAKED_ANIMATION_STEP and
+           actor->BakedBytes(step) + sizeof(u32) > (u32)allocator->Free()) {
+      step *= 2;
+    }
+    if (step > MAX_BAKED_ANIMATION_STEP) {
+      debug::Log("No room to bake " + name);
+      continue;
     }
+    actor->BakeAnimations(allocator, step);
   }
 }
 
@@ -209,6 +243,7 @@ void Init(PikminGame& game) {
 
   LoadTextures(game);
   LoadActors(game);
+  BakeActorAnimations(game);
   particle_library::Init(game.TextureAllocator(), game.TexturePaletteAllocator());
   game.LoadLevel("/levels/collision_test.level");
 
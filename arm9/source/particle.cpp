@@ -1,15 +1,53 @@
 #include "particle.h"
 
+#include <algorithm>
+#include <functional>
+
 #include <nds.h>
 
 #include "numeric_types.h"
 #include "project_settings.h"
+#include "render/frustum.h"
 
 using numeric_types::literals::operator"" _f;
 using numeric_types::literals::operator"" _brad;
 using numeric_types::Brads;
+using numeric_types::fixed;
 
+// Live particles are packed into the front of the pool; everything from
+// g_active_particles on is free.
 Particle g_particles[MAX_PARTICLES];
+int g_active_particles = 0;
+u16 g_next_serial = 0;
+
+namespace {
+
+// A particle as this frame draws it.
+struct PreparedParticle {
+  Vec3 position;
+  fixed depth;
+  fixed radius;
+  fixed scale;
+  Brads rotation;
+  const ParticleMaterial* material;
+  u16 color;
+  u8 alpha;
+  u8 poly_id;
+};
+
+// This frame's particles, grouped by material.
+PreparedParticle g_prepared[MAX_PARTICLES];
+fixed g_prepared_depths[MAX_PARTICLES];
+int g_prepared_count = 0;
+
+// Where a quad's X, Y and Z axes end up after turning Y, then X, to face this
+// frame's camera. Each particle only has to spin and scale these within the
+// quad's plane, rather than have the hardware rotate twice.
+Vec3 g_facing_right;
+Vec3 g_facing_up;
+Vec3 g_facing_forward;
+
+}  // namespace
 
 u16 color_blend(u16 a, u16 b, u8 weight) {
   auto a_red =    a & 0x001F;
@@ -27,40 +65,42 @@ u16 color_blend(u16 a, u16 b, u8 weight) {
 }
 
 void UpdateParticles() {
-  for (int slot = 0; slot < MAX_PARTICLES; slot++) {
+  int slot = 0;
+  while (slot < g_active_particles) {
     Particle& particle = g_particles[slot];
-    if (particle.active) {
-      particle.age++;
-      if (particle.age > particle.lifespan) {
-        particle.active = false;
-      } else {
-        particle.position += particle.velocity;
-        particle.velocity += particle.acceleration;
-        particle.alpha = particle.alpha - particle.fade_rate;
-        particle.scale = particle.scale + particle.scale_rate;
-        particle.rotation += particle.rotation_rate;
-        if (particle.color_change_rate) {
-          particle.color_weight += particle.color_change_rate;
-          if (particle.color_weight > 31) {
-            particle.color_weight = 31;
-            particle.color_change_rate *= -1;
-          }
-          if (particle.color_weight < 0) {
-            particle.color_weight = 0;
-            particle.color_change_rate *= -1;
-          }
-          particle.color = color_blend(particle.color_a, particle.color_b, particle.color_weight);
-        }
+    particle.age++;
+    if (particle.age > particle.lifespan) {
+      // Fill the gap with the last live particle, and update that one here
+      // instead.
+      g_active_particles--;
+      particle = g_particles[g_active_particles];
+      continue;
+    }
+    particle.position += particle.velocity;
+    particle.velocity += particle.acceleration;
+    particle.alpha = particle.alpha - particle.fade_rate;
+    particle.scale = particle.scale + particle.scale_rate;
+    particle.rotation += particle.rotation_rate;
+    if (particle.color_change_rate) {
+      particle.color_weight += particle.color_change_rate;
+      if (particle.color_weight > 31) {
+        particle.color_weight = 31;
+        particle.color_change_rate *= -1;
       }
+      if (particle.color_weight < 0) {
+        particle.color_weight = 0;
+        particle.color_change_rate *= -1;
+      }
+      particle.color = color_blend(particle.color_a, particle.color_b, particle.color_weight);
     }
+    slot++;
   }
 }
 
-void DrawParticles(Vec3 camera_position, Vec3 target_position) {
-  // figure out the angle toward the camera (From the target; this will
-  // end up being shared among all particles)
-  Brads x_angle;
-  Brads y_angle;
+void CameraFacingAngles(Vec3 camera_position, Vec3 target_position,
+    Brads& x_angle, Brads& y_angle) {
+  x_angle = 0_brad;
+  y_angle = 0_brad;
   auto difference_xz = Vec2{camera_position.x, camera_position.z} -
       Vec2{target_position.x, target_position.z};
   if (difference_xz.Length2() > 0_f) {
@@ -81,92 +121,222 @@ void DrawParticles(Vec3 camera_position, Vec3 target_position) {
       x_angle = Brads::Raw(-acosLerp(difference.x.data_));
     }
   }
+}
 
-  for (int slot = 0; slot < MAX_PARTICLES; slot++) {
-    Particle& particle = g_particles[slot];
-    if (particle.active) {
-      int alpha = (int)(particle.alpha * 31_f);
-      if (alpha > 31) {
-        alpha = 31;
+void SetParticleMaterial(const ParticleMaterial* material) {
+  if (material == nullptr) {
+    // TEXIMAGE_PARAM; untextured
+    *((u32*)0x40004A8) = 0;
+    return;
+  }
+  const Texture& texture = material->texture;
+  // TEXIMAGE_PARAM
+  *((u32*)0x40004A8) =
+    ((((u32)texture.offset) / 8) & 0xFFFF) |
+    (texture.format_width << 20) |
+    (texture.format_height << 23) |
+    (texture.format << 26) |
+    (texture.transparency << 29);
+
+  // PLTT_BASE
+  if (texture.format == GL_RGB4) {
+    *((u32*)0x40004AC) =
+      ((u32)material->palette.offset - (u32)VRAM_G) / 8;
+  } else {
+    *((u32*)0x40004AC) =
+      ((u32)material->palette.offset - (u32)VRAM_G) / 16;
+  }
+}
+
+int PrepareParticles(const render::Frustum& frustum, Vec3 camera_position,
+    Vec3 target_position, fixed thin_distance) {
+  // figure out the angle toward the camera (From the target; this will
+  // end up being shared among all particles)
+  Brads x_angle;
+  Brads y_angle;
+  CameraFacingAngles(camera_position, target_position, x_angle, y_angle);
+  const fixed sin_x = fixed::FromRaw(sinLerp(x_angle.data_));
+  const fixed cos_x = fixed::FromRaw(cosLerp(x_angle.data_));
+  const fixed sin_y = fixed::FromRaw(sinLerp(y_angle.data_));
+  const fixed cos_y = fixed::FromRaw(cosLerp(y_angle.data_));
+  g_facing_right = Vec3{cos_y, 0_f, 0_f - sin_y};
+  g_facing_up = Vec3{sin_x * sin_y, cos_x, sin_x * cos_y};
+  g_facing_forward = Vec3{cos_x * sin_y, 0_f - sin_x, cos_x * cos_y};
+
+  g_prepared_count = 0;
+  for (int slot = 0; slot < g_active_particles; slot++) {
+    const Particle& particle = g_particles[slot];
+    int alpha = (int)(particle.alpha * 31_f);
+    if (alpha > 31) {
+      alpha = 31;
+    }
+    if (alpha <= 1) {
+      continue;
+    }
+
+    // The quad's corners are sqrt(2) * scale from its center.
+    fixed radius = particle.scale * 1.5_f;
+    if (radius < 0_f) {
+      radius = 0_f - radius;
+    }
+    fixed depth;
+    if (not frustum.TestSphere(particle.position, radius, depth)) {
+      continue;
+    }
+    if (thin_distance > 0_f) {
+      int thinning = 0;
+      for (fixed reach = thin_distance; thinning < 3 and depth > reach;
+          reach = reach * 2_f) {
+        thinning++;
       }
-      if (alpha > 1) {
-        glPolyFmt(POLY_ALPHA(alpha) | POLY_ID((slot & 0x1F) | 0x20) | POLY_CULL_BACK);
-        // Note: The OpenGL functions depend on internal state, and using them
-        // here would cause a lot of overhead, so we're writing to the
-        // registers manually.
-        glBegin(GL_QUAD);
-        // TEXIMAGE_PARAM
-        *((u32*)0x40004A8) =
-          ((((u32)particle.texture.offset) / 8) & 0xFFFF) |
-          (particle.texture.format_width << 20) |
-          (particle.texture.format_height << 23) |
-          (particle.texture.format << 26) |
-          (particle.texture.transparency << 29);
-
-        // PLTT_BASE
-        if (particle.texture.format == GL_RGB4) {
-          *((u32*)0x40004AC) =
-            ((u32)particle.palette.offset - (u32)VRAM_G) / 8;
-        } else {
-          *((u32*)0x40004AC) =
-            ((u32)particle.palette.offset - (u32)VRAM_G) / 16;
-        }
-
-        glPushMatrix();
-        glTranslatef32(particle.position.x.data_, particle.position.y.data_,
-          particle.position.z.data_);
-        glRotateYi(y_angle.data_);
-        glRotateXi(x_angle.data_);
-        if (particle.rotation != 0_brad) {
-          glRotateZi(particle.rotation.data_);
-        }
-        glScalef32(particle.scale.data_, particle.scale.data_, particle.scale.data_);
-
-        auto texture_width = (8 << particle.texture.format_width);
-        auto texture_height = (8 << particle.texture.format_height);
-
-        glColor(particle.color);
-        glTexCoord2t16(0, 0);
-        glVertex3v16(-1 << 12,  1 << 12, 0);
-        glTexCoord2t16((texture_width) << 4,  0);
-        glVertex3v16( 1 << 12,  1 << 12, 0);
-        glTexCoord2t16((texture_width) << 4,  (texture_height) << 4);
-        glVertex3v16( 1 << 12, -1 << 12, 0);
-        glTexCoord2t16(0,  (texture_height) << 4);
-        glVertex3v16(-1 << 12, -1 << 12, 0);
-        glEnd();
-
-        glPopMatrix(1);
+      if (particle.serial & ((1 << thinning) - 1)) {
+        continue;
       }
     }
+
+    PreparedParticle& prepared = g_prepared[g_prepared_count++];
+    prepared.position = particle.position;
+    prepared.depth = depth;
+    prepared.radius = radius;
+    prepared.scale = particle.scale;
+    prepared.rotation = particle.rotation;
+    prepared.material = particle.material;
+    prepared.color = particle.color;
+    prepared.alpha = alpha;
+    prepared.poly_id = (particle.serial & 0x1F) | 0x20;
+  }
+
+  if (g_prepared_count > PARTICLE_POLYGON_BUDGET) {
+    // The farthest particles are the smallest on screen, so they go first.
+    std::nth_element(g_prepared, g_prepared + PARTICLE_POLYGON_BUDGET,
+        g_prepared + g_prepared_count,
+        [](const PreparedParticle& a, const PreparedParticle& b) {
+          return a.depth < b.depth;
+        });
+    g_prepared_count = PARTICLE_POLYGON_BUDGET;
+  }
+
+  for (int i = 0; i < g_prepared_count; i++) {
+    g_prepared_depths[i] = g_prepared[i].depth;
   }
+  std::sort(g_prepared_depths, g_prepared_depths + g_prepared_count,
+      [](fixed a, fixed b) {
+        return b < a;
+      });
+  std::sort(g_prepared, g_prepared + g_prepared_count,
+      [](const PreparedParticle& a, const PreparedParticle& b) {
+        return std::less<const ParticleMaterial*>()(a.material, b.material);
+      });
+  return g_prepared_count;
 }
 
-Particle* SpawnParticle(Particle& prototype) {
-  //find the first unused slot and put the particle there
-  for (int slot = 0; slot < MAX_PARTICLES; slot++) {
-    if (!g_particles[slot].active) {
-      g_particles[slot] = prototype;
-      //initialize hidden / tracking parameters
-      g_particles[slot].active = true;
-      g_particles[slot].age = 0;
-      if (prototype.color_change_rate) {
-        g_particles[slot].color = prototype.color_a;
+const fixed* PreparedParticleDepths() {
+  return g_prepared_depths;
+}
+
+int DrawParticles(fixed near, fixed far, const render::Frustum* frustum) {
+  const ParticleMaterial* material = nullptr;
+  bool material_set = false;
+  int texture_width = 8;
+  int texture_height = 8;
+  int drawn = 0;
+  for (int i = 0; i < g_prepared_count; i++) {
+    const PreparedParticle& particle = g_prepared[i];
+    if (particle.depth < near or not (particle.depth < far)) {
+      continue;
+    }
+    fixed depth;
+    if (frustum != nullptr and
+        not frustum->TestSphere(particle.position, particle.radius, depth)) {
+      continue;
+    }
+    // Note: The OpenGL functions depend on internal state, and using them
+    // here would cause a lot of overhead, so we're writing to the registers
+    // manually.
+    if (not material_set or particle.material != material) {
+      material = particle.material;
+      material_set = true;
+      SetParticleMaterial(material);
+      if (material != nullptr) {
+        texture_width = (8 << material->texture.format_width);
+        texture_height = (8 << material->texture.format_height);
       }
+    }
+
+    glPolyFmt(POLY_ALPHA(particle.alpha) | POLY_ID(particle.poly_id) | POLY_CULL_BACK);
+    glBegin(GL_QUAD);
 
-      return &g_particles[slot];
+    // Spin and scale within the quad's plane.
+    fixed along = particle.scale;
+    fixed across = 0_f;
+    if (particle.rotation != 0_brad) {
+      along = fixed::FromRaw(cosLerp(particle.rotation.data_)) * particle.scale;
+      across = fixed::FromRaw(sinLerp(particle.rotation.data_)) * particle.scale;
     }
+    const Vec3 x_axis = g_facing_right * along + g_facing_up * across;
+    const Vec3 y_axis = g_facing_up * along - g_facing_right * across;
+    const Vec3 z_axis = g_facing_forward * particle.scale;
+
+    glPushMatrix();
+    MATRIX_MULT4x3 = x_axis.x.data_;
+    MATRIX_MULT4x3 = x_axis.y.data_;
+    MATRIX_MULT4x3 = x_axis.z.data_;
+
+    MATRIX_MULT4x3 = y_axis.x.data_;
+    MATRIX_MULT4x3 = y_axis.y.data_;
+    MATRIX_MULT4x3 = y_axis.z.data_;
+
+    MATRIX_MULT4x3 = z_axis.x.data_;
+    MATRIX_MULT4x3 = z_axis.y.data_;
+    MATRIX_MULT4x3 = z_axis.z.data_;
+
+    MATRIX_MULT4x3 = particle.position.x.data_;
+    MATRIX_MULT4x3 = particle.position.y.data_;
+    MATRIX_MULT4x3 = particle.position.z.data_;
+
+    glColor(particle.color);
+    glTexCoord2t16(0, 0);
+    glVertex3v16(-1 << 12,  1 << 12, 0);
+    glTexCoord2t16((texture_width) << 4,  0);
+    glVertex3v16( 1 << 12,  1 << 12, 0);
+    glTexCoord2t16((texture_width) << 4,  (texture_height) << 4);
+    glVertex3v16( 1 << 12, -1 << 12, 0);
+    glTexCoord2t16(0,  (texture_height) << 4);
+    glVertex3v16(-1 << 12, -1 << 12, 0);
+    glEnd();
+
+    glPopMatrix(1);
+    drawn++;
   }
-  return nullptr;
+  return drawn;
 }
 
-// Note: slow! for debugging only; don't rely on this for gameplay.
-int ActiveParticles() {
-  int active = 0;
-  for (int slot = 0; slot < MAX_PARTICLES; slot++) {
-    if (g_particles[slot].active) {
-      active++;
+Particle* SpawnParticle(Particle& prototype) {
+  int slot = g_active_particles;
+  if (slot < MAX_PARTICLES) {
+    g_active_particles++;
+  } else {
+    // Rather than fail, take over from whichever particle has the least life
+    // left; it's likely faded out by now anyway.
+    slot = 0;
+    for (int i = 1; i < MAX_PARTICLES; i++) {
+      if (g_particles[i].lifespan - g_particles[i].age <
+          g_particles[slot].lifespan - g_particles[slot].age) {
+        slot = i;
+      }
     }
   }
-  return active;
+  Particle& particle = g_particles[slot];
+  particle = prototype;
+  //initialize hidden / tracking parameters
+  particle.age = 0;
+  particle.serial = g_next_serial++;
+  if (prototype.color_change_rate) {
+    particle.color = prototype.color_a;
+  }
+  return &particle;
+}
+
+int ActiveParticles() {
+  return g_active_particles;
 }
@@ -4,6 +4,18 @@
 #include "vector.h"
 #include "vram_allocator.h"
 
+namespace render {
+class Frustum;
+}  // namespace render
+
+// A texture and palette, shared by every particle drawn with them. Particles
+// are drawn grouped by material, so the texture registers are only written
+// once per group.
+struct ParticleMaterial {
+  Texture texture;
+  TexturePalette palette;
+};
+
 struct Particle {
   Vec3 position;
   Vec3 velocity;
@@ -11,10 +23,11 @@ struct Particle {
 
   u16 lifespan;
   u16 age;
+  // Counts up with every particle spawned; decides which particles are
+  // thinned out with distance, so the same ones stay hidden frame to frame.
+  u16 serial;
 
-  bool active;
-  Texture texture;
-  TexturePalette palette;
+  const ParticleMaterial* material{nullptr};
 
   numeric_types::fixed alpha{numeric_types::fixed::FromInt(1)};
   numeric_types::fixed fade_rate;
@@ -35,8 +48,30 @@ struct Particle {
 };
 
 void UpdateParticles();
+// Copies the prototype into a free slot and returns it. Once all
+// MAX_PARTICLES are in use, the particle closest to expiring makes way. Live
+// particles are kept packed together, and UpdateParticles moves them to fill
+// the gaps left by expired ones, so the pointer is only good until the next
+// UpdateParticles.
 Particle* SpawnParticle(Particle& prototype);
-void DrawParticles(Vec3 camera_position, Vec3 target_position);
+// Once per frame, before its first pass: takes a copy of the particles inside
+// the frustum for the frame's passes to draw from, since particles keep
+// moving in between them. Past thin_distance deep, only every other particle
+// is kept, past twice that every fourth, and past four times every eighth; 0
+// keeps them all. If more than PARTICLE_POLYGON_BUDGET are left, the farthest
+// are dropped. Returns how many particles (and so polygons) were kept.
+int PrepareParticles(const render::Frustum& frustum, Vec3 camera_position,
+    Vec3 target_position, numeric_types::fixed thin_distance);
+// Depths of the prepared particles, deepest first.
+const numeric_types::fixed* PreparedParticleDepths();
+// Draws the prepared particles at least near and less than far deep, that
+// also touch the frustum if one is given. Returns how many were drawn.
+int DrawParticles(numeric_types::fixed near, numeric_types::fixed far,
+    const render::Frustum* frustum = nullptr);
+// Rotations (Y, then X) that turn a quad in the XY plane to face the camera.
+// Worked out from the target, so they can be shared by everything drawn.
+void CameraFacingAngles(Vec3 camera_position, Vec3 target_position,
+    numeric_types::Brads& x_angle, numeric_types::Brads& y_angle);
 int ActiveParticles();
 
 #endif
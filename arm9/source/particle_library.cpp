@@ -15,12 +15,38 @@ Particle smoke;
 Particle piki_star;
 Particle rock;
 
-void Init(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator) {
-  dirt_cloud.texture = texture_allocator->Retrieve("smoke1.a5i3");
-  dirt_cloud.palette = palette_allocator->Retrieve("smoke1.a5i3");
+namespace {
+
+// Shared by every particle spawned from the prototypes that use them, so
+// particles with the same texture are drawn together.
+ParticleMaterial smoke_material;
+ParticleMaterial fire_material;
+ParticleMaterial star_material;
+ParticleMaterial rock_material;
+
+void LoadMaterial(ParticleMaterial& material, const char* name, int format_width,
+    int format_height, VramAllocator<Texture>* texture_allocator,
+    VramAllocator<TexturePalette>* palette_allocator) {
+  material.texture = texture_allocator->Retrieve(name);
+  material.palette = palette_allocator->Retrieve(name);
   // Perhaps we should be reading in the width/height from the image on disk?
-  dirt_cloud.texture.format_width = TEXTURE_SIZE_32;
-  dirt_cloud.texture.format_height = TEXTURE_SIZE_32;
+  material.texture.format_width = format_width;
+  material.texture.format_height = format_height;
+}
+
+}  // namespace
+
+void Init(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalette>* palette_allocator) {
+  LoadMaterial(smoke_material, "smoke1.a5i3", TEXTURE_SIZE_32, TEXTURE_SIZE_32,
+      texture_allocator, palette_allocator);
+  LoadMaterial(fire_material, "fire.a3i5", TEXTURE_SIZE_32, TEXTURE_SIZE_32,
+      texture_allocator, palette_allocator);
+  LoadMaterial(star_material, "star.a5i3", TEXTURE_SIZE_16, TEXTURE_SIZE_16,
+      texture_allocator, palette_allocator);
+  LoadMaterial(rock_material, "rock.t2bpp", TEXTURE_SIZE_16, TEXTURE_SIZE_16,
+      texture_allocator, palette_allocator);
+
+  dirt_cloud.material = &smoke_material;
   dirt_cloud.lifespan = 12;
   dirt_cloud.alpha = 0.75_f;
   dirt_cloud.fade_rate = dirt_cloud.alpha / fixed::FromInt(dirt_cloud.lifespan);
@@ -28,30 +54,20 @@ void Init(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalett
   dirt_cloud.scale_rate = 0.02_f;
   dirt_cloud.color = RGB15(13,8,6);
 
-  fire.texture = texture_allocator->Retrieve("fire.a3i5");
-  fire.palette = palette_allocator->Retrieve("fire.a3i5");
-  // Perhaps we should be reading in the width/height from the image on disk?
-  fire.texture.format_width = TEXTURE_SIZE_32;
-  fire.texture.format_height = TEXTURE_SIZE_32;
+  fire.material = &fire_material;
   fire.lifespan = 16;
   fire.fade_rate = 1_f / 32_f;
   fire.scale = 2.0_f;
   fire.scale_rate = 0.08_f;
 
-  smoke.texture = texture_allocator->Retrieve("smoke1.a5i3");
-  smoke.palette = palette_allocator->Retrieve("smoke1.a5i3");
-  smoke.texture.format_width = TEXTURE_SIZE_32;
-  smoke.texture.format_height = TEXTURE_SIZE_32;
+  smoke.material = &smoke_material;
   smoke.lifespan = 16;
   smoke.alpha = 0.5_f;
   smoke.fade_rate = 0.5_f / 16_f;
   smoke.scale = 2.0_f;
   smoke.scale_rate = 0.1_f;
 
-  piki_star.texture = texture_allocator->Retrieve("star.a5i3");
-  piki_star.palette = palette_allocator->Retrieve("star.a5i3");
-  piki_star.texture.format_width = TEXTURE_SIZE_16;
-  piki_star.texture.format_height = TEXTURE_SIZE_16;
+  piki_star.material = &star_material;
   piki_star.lifespan = 32;
   piki_star.scale = 0.6_f;
   piki_star.alpha = 0.75_f;
@@ -62,11 +78,7 @@ void Init(VramAllocator<Texture>* texture_allocator, VramAllocator<TexturePalett
   piki_star.rotation = 45_brad;
   piki_star.rotation_rate = 5_brad;
 
-  rock.texture = texture_allocator->Retrieve("rock.t2bpp");
-  rock.palette = palette_allocator->Retrieve("rock.t2bpp");
-  // Perhaps we should be reading in the width/height from the image on disk?
-  rock.texture.format_width = TEXTURE_SIZE_16;
-  rock.texture.format_height = TEXTURE_SIZE_16;
+  rock.material = &rock_material;
   rock.lifespan = 16;
   rock.fade_rate = 1_f / 32_f;
   rock.scale = 0.4_f;
@@ -0,0 +1,43 @@
+#ifndef PHYSICS_AREA_TRIGGER_H
+#define PHYSICS_AREA_TRIGGER_H
+
+#include "handle.h"
+#include "numeric_types.h"
+#include "vector.h"
+
+namespace physics {
+
+struct Body;
+
+// A sensor cylinder that isn't a Body. Triggers never move, push, or get
+// pushed; bodies simply sense them as if they were sensor bodies of the same
+// collision group. They're meant to be allocated once by their owner and
+// toggled with `enabled`, rather than churned through the body allocator.
+struct AreaTrigger {
+  Handle handle;
+  Handle owner;
+
+  // If set, the trigger is centered on this body every tick, and collision
+  // results against the trigger report this body.
+  Handle anchor;
+
+  Vec3 position = Vec3{
+    numeric_types::Fixed<s32,12>::FromInt(0),
+    numeric_types::Fixed<s32,12>::FromInt(0),
+    numeric_types::Fixed<s32,12>::FromInt(0)
+  };
+  numeric_types::Fixed<s32,12> height = numeric_types::Fixed<s32,12>::FromInt(1);
+  numeric_types::Fixed<s32,12> radius = numeric_types::Fixed<s32,12>::FromInt(1);
+
+  u32 collision_group{0};
+
+  bool enabled{false};
+  bool active{false};
+
+  // Resolved from anchor once per tick by the World.
+  Body* anchor_body{nullptr};
+};
+
+}  // namespace physics
+
+#endif  // PHYSICS_AREA_TRIGGER_H
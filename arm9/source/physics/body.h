@@ -19,19 +19,10 @@ struct BodyHandle {
   bool IsValid() const;
 };
 
-struct CollisionResult {
-  Body* body;
-  u32 collision_group;
-};
-
-struct Neighbor {
-  BodyHandle handle;
-  numeric_types::Fixed<s32,12> distance = numeric_types::Fixed<s32,12>::FromInt(0);
-};
-
+// Hot per-body data, walked every tick by the physics loop. Anything touched
+// less often lives in World's cold tables (see BodyColdData), to keep this
+// array small enough to play nicely with the ARM9's data cache.
 struct Body {
-  Handle handle;
-
   friend class World;
   //movement information
   Vec3 position = Vec3{
@@ -43,40 +34,25 @@ struct Body {
     numeric_types::Fixed<s32,12>::FromInt(0),
     numeric_types::Fixed<s32,12>::FromInt(0),
     numeric_types::Fixed<s32,12>::FromInt(0)
-  };;
+  };
   Vec3 acceleration = Vec3{
     numeric_types::Fixed<s32,12>::FromInt(0),
     numeric_types::Fixed<s32,12>::FromInt(0),
     numeric_types::Fixed<s32,12>::FromInt(0)
-  };;
-
-  Vec2 xz_position = Vec2{
-    numeric_types::Fixed<s32,12>::FromInt(0),
-    numeric_types::Fixed<s32,12>::FromInt(0)
-  };;
+  };
 
   //all bodies are cylinders, so they have a radius and a height. Their base
   //starts at position.y, so their highest point is at position.y + height.
   numeric_types::Fixed<s32,12> height = numeric_types::Fixed<s32,12>::FromInt(1);
   numeric_types::Fixed<s32,12> radius = numeric_types::Fixed<s32,12>::FromInt(1);
-  //numeric_types::Fixed<s32,12> radius2;
-
-  // Stores a handle to the owner of this body, helpful when reacting to
-  // collisions.
-  Handle owner;
 
   //list of which collision groups we BELONG TO
   u32 collision_group{0};
 
-  //list of all groups which we WANT TO KNOW ABOUT
+  //list of all groups which we WANT TO KNOW ABOUT; anything sensed is
+  //reported through the World's contact list
   u32 sensor_groups{0};
 
-  //contains all the groups we collided with *this frame*
-  u32 result_groups{0};
-
-  u32 num_results{0};
-  CollisionResult collision_results[8];
-
   unsigned short touching_ground : 1;
 
   //collision parameters
@@ -89,17 +65,31 @@ struct Body {
   unsigned short affected_by_gravity : 1;
   unsigned short is_very_important : 1;
 
-  CollisionResult FirstCollisionWith(u32 collision_mask);
   unsigned short active : 1;
+  unsigned short sleeping : 1;  // Skips movement and level collision
   unsigned short generation;
-  Vec3 old_position;
-  numeric_types::Fixed<s32,12> old_radius;
 
-  std::array<Neighbor, MAX_PHYSICS_NEIGHBORS> neighbors;
+  // Consecutive ticks this body has been at rest; it sleeps once this reaches
+  // PHYSICS_SLEEP_TICKS.
+  u8 still_ticks{0};
 
   BodyHandle GetHandle();
 };
 
+// Per-body data the physics loop rarely touches. World stores these in a table
+// parallel to its Body array, indexed by body id.
+struct BodyColdData {
+  Handle handle;
+
+  // Stores a handle to the owner of this body, helpful when reacting to
+  // collisions.
+  Handle owner;
+
+  // Every collision group among this body's contacts that began or persisted
+  // last tick, so World::Senses doesn't have to search the contact list.
+  u32 sensed_groups{0};
+};
+
 }  // namespace physics
 
 #endif  // PHYSICS_BODY_H
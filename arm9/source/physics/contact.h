@@ -0,0 +1,39 @@
+#ifndef PHYSICS_CONTACT_H
+#define PHYSICS_CONTACT_H
+
+#include <nds/ndstypes.h>
+
+#include "handle.h"
+
+namespace physics {
+
+struct Body;
+
+enum class ContactPhase : u8 {
+  kBegin = 0,  // Started overlapping this tick
+  kPersist,    // Was already overlapping last tick
+  kEnd,        // Stopped overlapping this tick, or one side went away
+};
+
+// A body sensing something in its sensor_groups. The World reports these once
+// per tick, grouped by the sensing body, so owners can react to a contact
+// starting or ending instead of re-checking every frame.
+struct Contact {
+  // The body doing the sensing.
+  Handle sensor;
+
+  // Whatever was actually sensed. For area triggers this is the trigger's
+  // handle, and body is the trigger's anchor (if any).
+  Handle handle;
+  Body* body{nullptr};  // Always null for kEnd; it may not exist anymore
+
+  u32 collision_group{0};
+  ContactPhase phase{ContactPhase::kBegin};
+
+  // Sort key, used by the World to match contacts between ticks.
+  u32 key{0};
+};
+
+}  // namespace physics
+
+#endif  // PHYSICS_CONTACT_H
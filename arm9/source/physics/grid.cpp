@@ -0,0 +1,87 @@
+#include "grid.h"
+
+using physics::Grid;
+using physics::GridEntry;
+using physics::CellBounds;
+using numeric_types::fixed;
+
+static_assert((PHYSICS_GRID_BUCKETS & (PHYSICS_GRID_BUCKETS - 1)) == 0,
+    "PHYSICS_GRID_BUCKETS must be a power of two");
+static_assert(MAX_PHYSICS_GRID_ENTRIES <= 0xFFFF,
+    "Grid bucket offsets are stored as u16");
+
+int CellBounds::Cells() const {
+  return (max_x - min_x + 1) * (max_z - min_z + 1);
+}
+
+Grid::Grid(int cell_shift) : cell_shift_{cell_shift} {
+}
+
+CellBounds Grid::BoundsFor(const Vec3& position, fixed radius) const {
+  // Fixed to int conversion floors, so negative coordinates land in the
+  // correct cell without any special casing.
+  CellBounds bounds;
+  bounds.min_x = (int)(position.x - radius) >> cell_shift_;
+  bounds.min_z = (int)(position.z - radius) >> cell_shift_;
+  bounds.max_x = (int)(position.x + radius) >> cell_shift_;
+  bounds.max_z = (int)(position.z + radius) >> cell_shift_;
+  return bounds;
+}
+
+int Grid::Bucket(int x, int z) {
+  // Multiplied unsigned, so large cell coordinates wrap instead of overflowing.
+  return ((u32)x * 73856093u ^ (u32)z * 19349663u) &
+      (PHYSICS_GRID_BUCKETS - 1);
+}
+
+void Grid::Clear() {
+  for (int i = 0; i <= PHYSICS_GRID_BUCKETS; i++) {
+    bucket_start_[i] = 0;
+  }
+  reserved_entries_ = 0;
+}
+
+bool Grid::Reserve(const CellBounds& bounds) {
+  if (reserved_entries_ + bounds.Cells() > MAX_PHYSICS_GRID_ENTRIES) {
+    return false;
+  }
+  reserved_entries_ += bounds.Cells();
+  // Count into the *next* bucket's start, so that Finalize's running sum
+  // leaves each bucket_start_ pointing at the beginning of its own range.
+  for (int z = bounds.min_z; z <= bounds.max_z; z++) {
+    for (int x = bounds.min_x; x <= bounds.max_x; x++) {
+      bucket_start_[Bucket(x, z) + 1]++;
+    }
+  }
+  return true;
+}
+
+void Grid::Finalize() {
+  for (int i = 0; i < PHYSICS_GRID_BUCKETS; i++) {
+    bucket_start_[i + 1] += bucket_start_[i];
+    bucket_fill_[i] = bucket_start_[i];
+  }
+}
+
+void Grid::Insert(int body, const CellBounds& bounds) {
+  for (int z = bounds.min_z; z <= bounds.max_z; z++) {
+    for (int x = bounds.min_x; x <= bounds.max_x; x++) {
+      GridEntry& entry = entries_[bucket_fill_[Bucket(x, z)]++];
+      entry.x = x;
+      entry.z = z;
+      entry.body = body;
+    }
+  }
+}
+
+const GridEntry* Grid::Begin(int x, int z) const {
+  return &entries_[bucket_start_[Bucket(x, z)]];
+}
+
+const GridEntry* Grid::End(int x, int z) const {
+  return &entries_[bucket_start_[Bucket(x, z) + 1]];
+}
+
+int Grid::Entries() const {
+  return reserved_entries_;
+}
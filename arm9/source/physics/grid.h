@@ -0,0 +1,65 @@
+#ifndef PHYSICS_GRID_H
+#define PHYSICS_GRID_H
+
+#include <nds/ndstypes.h>
+
+#include "numeric_types.h"
+#include "project_settings.h"
+#include "vector.h"
+
+namespace physics {
+
+// Inclusive range of grid cells touched by a body's footprint on the XZ plane.
+struct CellBounds {
+  s16 min_x;
+  s16 min_z;
+  s16 max_x;
+  s16 max_z;
+
+  int Cells() const;
+};
+
+struct GridEntry {
+  s16 x;
+  s16 z;
+  u16 body;
+};
+
+// Uniform grid broadphase. Cells are a power of two multiple of the heightmap's
+// 1-unit tiles, and are hashed into a fixed number of buckets so the grid's
+// memory doesn't depend on the size of the level. The grid is rebuilt with a
+// counting sort: Reserve every body, Finalize, then Insert every body again
+// with the same bounds. Two linear passes, no allocation.
+class Grid {
+  public:
+    explicit Grid(int cell_shift = PHYSICS_GRID_CELL_SHIFT);
+
+    CellBounds BoundsFor(const Vec3& position,
+                         numeric_types::fixed radius) const;
+
+    void Clear();
+    // Returns false (and reserves nothing) if the body won't fit.
+    bool Reserve(const CellBounds& bounds);
+    void Finalize();
+    void Insert(int body, const CellBounds& bounds);
+
+    // Entries sharing a bucket with cell (x, z). Hash collisions mean callers
+    // still need to check the entry's own cell coordinates.
+    const GridEntry* Begin(int x, int z) const;
+    const GridEntry* End(int x, int z) const;
+
+    int Entries() const;
+
+  private:
+    static int Bucket(int x, int z);
+
+    int cell_shift_;
+    u16 bucket_start_[PHYSICS_GRID_BUCKETS + 1];
+    u16 bucket_fill_[PHYSICS_GRID_BUCKETS];
+    int reserved_entries_ = 0;
+    GridEntry entries_[MAX_PHYSICS_GRID_ENTRIES];
+};
+
+}  // namespace physics
+
+#endif  // PHYSICS_GRID_H
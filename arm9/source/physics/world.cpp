@@ -1,5 +1,7 @@
 #include "world.h"
 
+#include <algorithm>
+
 #include "debug/messages.h"
 #include "debug/profiler.h"
 #include "debug/utilities.h"
@@ -10,8 +12,13 @@
 #include "stdlib.h"
 
 using physics::World;
+using physics::AreaTrigger;
 using physics::Body;
-using physics::BodyHandle;
+using physics::BodyColdData;
+using physics::CellBounds;
+using physics::Contact;
+using physics::ContactPhase;
+using physics::Grid;
 using numeric_types::fixed;
 using numeric_types::literals::operator"" _f;
 
@@ -19,135 +26,471 @@ World::World() {
   tMoveBodies =    debug::Profiler::RegisterTopic("Physics: Move Bodies");
   tCollideBodies = debug::Profiler::RegisterTopic("Physics: Collide Bodies");
   tCollideWorld =  debug::Profiler::RegisterTopic("Physics: Collide World");
+  tBroadphase =    debug::Profiler::RegisterTopic("Physics: Broadphase");
 
   tAA = debug::Profiler::RegisterTopic("Physics: Bodies: A vs A");
   tAP = debug::Profiler::RegisterTopic("Physics: Bodies: A vs P");
   tPP = debug::Profiler::RegisterTopic("Physics: Bodies: P vs P");
+  tContacts = debug::Profiler::RegisterTopic("Physics: Contacts");
+
+  ResetFreeList();
 }
 
 World::~World() {
 }
 
-Body* World::AllocateBody(Handle owner) {
-  // This is a fairly naive implementation.
-
-  // Note: A return value of 0 (Null) indicates failure.
+void World::ResetFreeList() {
+  // Chain every slot together in order, so a fresh world allocates from the
+  // bottom up.
   for (int i = 0; i < MAX_PHYSICS_BODIES; i++) {
-    if (bodies_[i].active == 0) {
-      Body default_zeroed = {};
-      bodies_[i] = default_zeroed;
-
-      bodies_[i].touching_ground = 0;
-      bodies_[i].is_sensor = 0;
-      bodies_[i].collides_with_bodies = 1;
-      bodies_[i].collides_with_level = 1;
-      bodies_[i].ignores_walls = 0;
-      bodies_[i].is_movable = 0;
-      bodies_[i].is_pikmin = 0;
-      bodies_[i].affected_by_gravity = 1;
-      bodies_[i].active = 1;
-      bodies_[i].is_very_important = 0;
-
-      bodies_[i].owner = owner;
-      bodies_[i].generation = current_generation_;
-      rebuild_index_ = true;
-
-      // Old-style handle, kept here for compatability reasons.
-      // TODO: Remove this when reliance on this handle is refactored out.
-      BodyHandle handle;
-      handle.body = &bodies_[i];
-      handle.generation = current_generation_;
-
-      // New-style handle, used for safer references to Physics bodies by
-      // non-owners.
-      bodies_[i].handle.id = i;
-      bodies_[i].handle.generation = current_generation_;
-      bodies_[i].handle.type = World::kBody;
-
-      // Clear out the neighbor list for newly created bodies, to avoid weirdness
-      for (int n = 0; n < MAX_PHYSICS_NEIGHBORS; n++) {
-        bodies_[i].neighbors[n].handle.generation = -1;
-      }
+    index_list_[i] = kFree;
+    next_free_[i] = i + 1;
+  }
+  next_free_[MAX_PHYSICS_BODIES - 1] = -1;
+  first_free_ = 0;
+}
 
-      return &bodies_[i];
-    }
+Body* World::AllocateBody(Handle owner) {
+  // Note: A return value of 0 (Null) indicates failure.
+  if (first_free_ < 0) {
+    return nullptr;
   }
-  return nullptr;
+  const int i = first_free_;
+  first_free_ = next_free_[i];
+
+  // Generations are tracked per slot, and survive the slot being reused.
+  const unsigned int generation = cold_[i].handle.generation;
+
+  Body default_zeroed = {};
+  bodies_[i] = default_zeroed;
+  BodyColdData default_cold = {};
+  cold_[i] = default_cold;
+
+  bodies_[i].touching_ground = 0;
+  bodies_[i].is_sensor = 0;
+  bodies_[i].collides_with_bodies = 1;
+  bodies_[i].collides_with_level = 1;
+  bodies_[i].ignores_walls = 0;
+  bodies_[i].is_movable = 0;
+  bodies_[i].is_pikmin = 0;
+  bodies_[i].affected_by_gravity = 1;
+  bodies_[i].active = 1;
+  bodies_[i].is_very_important = 0;
+  bodies_[i].sleeping = 0;
+
+  cold_[i].owner = owner;
+
+  // Old-style handle generation, kept here for compatability reasons.
+  // TODO: Remove this when reliance on BodyHandle is refactored out.
+  bodies_[i].generation = generation;
+
+  // New-style handle, used for safer references to Physics bodies by
+  // non-owners.
+  cold_[i].handle.id = i;
+  cold_[i].handle.generation = generation;
+  cold_[i].handle.type = World::kBody;
+
+  // The owner hasn't set this body's flags yet, so we can't know which list
+  // it belongs in. It gets sorted at the start of the next Update.
+  AddToIndex(i, kPending);
+
+  return &bodies_[i];
 }
 
 void World::FreeBody(Body* body) {
   if (body) {
-    body->owner = Handle{};
+    const int id = IdOf(*body);
+    if (index_list_[id] == kFree) {
+      return;
+    }
+    RemoveFromIndex(id);
+    index_list_[id] = kFree;
+
+    BodyColdData& cold = cold_[id];
+    cold.owner = Handle{};
     body->active = 0;
-    body->handle.type = World::kNone;
-    rebuild_index_ = true;
-    current_generation_++;
+    cold.handle.type = World::kNone;
+
+    // Invalidate any handles still pointing at this slot
+    cold.handle.generation++;
+    body->generation = cold.handle.generation;
+
+    next_free_[id] = first_free_;
+    first_free_ = id;
   }
 }
 
 Body* World::RetrieveBody(Handle handle) {
   if (handle.id < MAX_PHYSICS_BODIES) {
     Body* body = &bodies_[handle.id];
-    if (body->active and body->handle.Matches(handle)) {
+    if (body->active and cold_[handle.id].handle.Matches(handle)) {
       return body;
     }
   }
   return nullptr;
 }
 
+int World::IdOf(const Body& body) const {
+  return &body - bodies_;
+}
+
+Handle World::HandleOf(Body* body) {
+  return cold_[IdOf(*body)].handle;
+}
+
+Handle World::Owner(Body* body) {
+  return cold_[IdOf(*body)].owner;
+}
+
+void World::SetOwner(Body* body, Handle owner) {
+  cold_[IdOf(*body)].owner = owner;
+}
+
+// Contacts are keyed by the sensing body's id, then by the grid id (body or
+// trigger) of whatever it sensed, so each body's contacts are contiguous.
+static_assert(MAX_PHYSICS_BODIES + MAX_AREA_TRIGGERS <= 0x10000,
+    "Contact keys pack two grid ids into 16 bits each");
+
+static u32 ContactKey(int sensor_id, Handle handle) {
+  u32 sensed_id = handle.id;
+  if (handle.type == World::kTrigger) {
+    sensed_id += MAX_PHYSICS_BODIES;
+  }
+  return ((u32)sensor_id << 16) | sensed_id;
+}
+
+static bool ContactKeyLess(const physics::Contact& a,
+                           const physics::Contact& b) {
+  return a.key < b.key;
+}
+
+const physics::Contact* World::Contacts(int& count) {
+  count = contact_count_[current_contacts_];
+  return contacts_[current_contacts_];
+}
+
+const physics::Contact* World::ContactsFor(Body* body, int& count) {
+  const Contact* contacts = contacts_[current_contacts_];
+  const Contact* end = contacts + contact_count_[current_contacts_];
+  Contact first;
+  first.key = (u32)IdOf(*body) << 16;
+  Contact last;
+  last.key = first.key | 0xFFFF;
+  auto begin = std::lower_bound(contacts, end, first, ContactKeyLess);
+  count = std::upper_bound(begin, end, last, ContactKeyLess) - begin;
+  // Every contact in the range comes from one sensor. If that was a body
+  // freed since the last tick, they aren't this body's.
+  if (count > 0 and not cold_[IdOf(*body)].handle.Matches(begin->sensor)) {
+    count = 0;
+  }
+  return begin;
+}
+
+physics::Contact World::FirstCollisionWith(Body* body, u32 collision_mask) {
+  if (not Senses(body, collision_mask)) {
+    return Contact();
+  }
+  int count;
+  const Contact* contacts = ContactsFor(body, count);
+  for (int i = 0; i < count; i++) {
+    if (contacts[i].phase != ContactPhase::kEnd and
+        (contacts[i].collision_group & collision_mask)) {
+      return contacts[i];
+    }
+  }
+  return Contact();
+}
+
+bool World::Senses(Body* body, u32 collision_mask) {
+  return cold_[IdOf(*body)].sensed_groups & collision_mask;
+}
+
+void World::AddContact(Body& body, Body* other, u32 collision_group,
+                       Handle handle) {
+  if (new_contact_count_ >= MAX_PHYSICS_CONTACTS) {
+    dropped_contacts_++;
+    return;
+  }
+  Contact& contact = new_contacts_[new_contact_count_++];
+  contact.sensor = cold_[IdOf(body)].handle;
+  contact.handle = handle;
+  contact.body = other;
+  contact.collision_group = collision_group;
+  contact.key = ContactKey(IdOf(body), handle);
+}
+
+void World::EmitContact(const Contact& contact, ContactPhase phase) {
+  int& count = contact_count_[current_contacts_];
+  if (count >= MAX_PHYSICS_CONTACTS) {
+    dropped_contacts_++;
+    return;
+  }
+  Contact& emitted = contacts_[current_contacts_][count++];
+  emitted = contact;
+  emitted.phase = phase;
+  if (phase == ContactPhase::kEnd) {
+    emitted.body = nullptr;
+    return;
+  }
+  cold_[contact.key >> 16].sensed_groups |= contact.collision_group;
+  if (phase == ContactPhase::kBegin) {
+    // Sensing something new is a good sign the owner is about to react to it.
+    Wake(&bodies_[contact.key >> 16]);
+  }
+}
+
+bool World::ContactStillAsleep(const Contact& contact) {
+  // Pairs of sleeping bodies skip collision entirely, so their contacts have
+  // to be carried over rather than rediscovered.
+  Body* sensor = RetrieveBody(contact.sensor);
+  if (sensor == nullptr or not sensor->sleeping) {
+    return false;
+  }
+  if (contact.handle.type != World::kBody) {
+    return false;  // Triggers are checked every tick regardless
+  }
+  Body* other = RetrieveBody(contact.handle);
+  return other != nullptr and other->sleeping;
+}
+
+void World::LoseContact(const Contact& contact) {
+  if (contact.phase == ContactPhase::kEnd) {
+    return;  // Already reported last tick
+  }
+  if (RetrieveBody(contact.sensor) == nullptr) {
+    // The sensor was freed, and its slot may already hold a body that never
+    // began this contact.
+    return;
+  }
+  if (ContactStillAsleep(contact)) {
+    EmitContact(contact, ContactPhase::kPersist);
+  } else {
+    EmitContact(contact, ContactPhase::kEnd);
+  }
+}
+
+void World::UpdateContacts() {
+  std::sort(new_contacts_, new_contacts_ + new_contact_count_, ContactKeyLess);
+
+  const Contact* previous = contacts_[current_contacts_];
+  const int previous_count = contact_count_[current_contacts_];
+  // Only bodies with contacts last tick can have sensed anything; the merge
+  // below fills their groups back in from whatever is still going.
+  for (int p = 0; p < previous_count; p++) {
+    cold_[previous[p].key >> 16].sensed_groups = 0;
+  }
+  current_contacts_ ^= 1;
+  contact_count_[current_contacts_] = 0;
+
+  // Both lists are sorted by key, so a single merge pass sorts out which
+  // contacts are new, which carried over, and which went away.
+  int n = 0;
+  int p = 0;
+  while (n < new_contact_count_ or p < previous_count) {
+    if (p >= previous_count or
+        (n < new_contact_count_ and new_contacts_[n].key < previous[p].key)) {
+      EmitContact(new_contacts_[n++], ContactPhase::kBegin);
+    } else if (n >= new_contact_count_ or
+               previous[p].key < new_contacts_[n].key) {
+      LoseContact(previous[p++]);
+    } else {
+      // Same slots, but one side may have been freed and reused in between.
+      Contact& current = new_contacts_[n++];
+      Contact old = previous[p++];
+      if (old.phase != ContactPhase::kEnd and
+          old.sensor.Matches(current.sensor) and
+          old.handle.Matches(current.handle)) {
+        EmitContact(current, ContactPhase::kPersist);
+      } else {
+        LoseContact(old);
+        EmitContact(current, ContactPhase::kBegin);
+      }
+    }
+  }
+  new_contact_count_ = 0;
+}
+
+void World::ResetContacts() {
+  for (int i = 0; i < MAX_PHYSICS_BODIES; i++) {
+    cold_[i].sensed_groups = 0;
+  }
+  new_contact_count_ = 0;
+  contact_count_[0] = 0;
+  contact_count_[1] = 0;
+}
+
 void World::ResetWorld() {
   for (int i = 0; i < MAX_PHYSICS_BODIES; i++) {
     FreeBody(&bodies_[i]);
   }
-  RebuildIndex();
+  ResetFreeList();
+  for (int i = 0; i < MAX_AREA_TRIGGERS; i++) {
+    FreeTrigger(&triggers_[i]);
+  }
+  ResetContacts();
+}
+
+physics::AreaTrigger* World::AllocateTrigger(Handle owner) {
+  // Triggers are allocated once per owner and then toggled, so a simple scan
+  // is plenty here.
+  for (int i = 0; i < MAX_AREA_TRIGGERS; i++) {
+    if (not triggers_[i].active) {
+      const unsigned int generation = triggers_[i].handle.generation;
+      AreaTrigger default_trigger = {};
+      triggers_[i] = default_trigger;
+      triggers_[i].active = true;
+      triggers_[i].enabled = true;
+      triggers_[i].owner = owner;
+      triggers_[i].handle.id = i;
+      triggers_[i].handle.generation = generation;
+      triggers_[i].handle.type = World::kTrigger;
+      return &triggers_[i];
+    }
+  }
+  return nullptr;
+}
+
+void World::FreeTrigger(AreaTrigger* trigger) {
+  if (trigger and trigger->active) {
+    trigger->active = false;
+    trigger->enabled = false;
+    trigger->owner = Handle{};
+    trigger->handle.type = World::kNone;
+    trigger->handle.generation++;
+  }
+}
+
+physics::AreaTrigger* World::RetrieveTrigger(Handle handle) {
+  if (handle.id < MAX_AREA_TRIGGERS) {
+    AreaTrigger* trigger = &triggers_[handle.id];
+    if (trigger->active and trigger->handle.Matches(handle)) {
+      return trigger;
+    }
+  }
+  return nullptr;
 }
 
 void World::Wake(Body* body) {
-  body->active = 1;
-  rebuild_index_ = true;
+  body->sleeping = 0;
+  body->still_ticks = 0;
 }
 
 void World::Sleep(Body* body) {
-  body->active = 0;
-  rebuild_index_ = true;
+  body->sleeping = 1;
+  // Remember where we came to rest; moving away from here wakes us back up.
+  body->velocity = Vec3{0_f, 0_f, 0_f};
+  old_position_[IdOf(*body)] = body->position;
 }
 
-void World::RebuildIndex() {
-  active_bodies_ = 0;
-  active_pikmin_ = 0;
-  important_bodies_ = 0;
-  for (int i = 0; i < MAX_PHYSICS_BODIES; i++) {
-    if (bodies_[i].active) {
-      if (bodies_[i].is_very_important) {
-        important_[important_bodies_++] = i;
-      } else {
-        if (bodies_[i].is_pikmin) {
-          pikmin_[active_pikmin_++] = i;
-        } else {
-          active_[active_bodies_++] = i;
-        }
-      }
+void World::WakeIfDisturbed(Body& body) {
+  // Game code writes to bodies directly all over the place, so rather than
+  // trusting every caller to wake us, look for any sign of outside meddling.
+  if (body.sleeping) {
+    if (not (body.velocity == Vec3{0_f, 0_f, 0_f}) or
+        not (body.acceleration == Vec3{0_f, 0_f, 0_f}) or
+        not (body.position == old_position_[IdOf(body)])) {
+      Wake(&body);
     }
   }
-  rebuild_index_ = false;
 }
 
-bool World::BodiesOverlap(Body& a, Body& b) {
-  if (&a == &b) {
-    return false; // Don't collide with yourself.
+// Bodies moving less than this (squared) distance in a tick are considered
+// to be at rest.
+const fixed kRestDistance2 = (1_f / 32_f) * (1_f / 32_f);
+
+void World::UpdateSleepState(Body& body) {
+  if (body.sleeping) {
+    sleeping_bodies_++;
+    return;
   }
-  bodies_overlapping_++;
+  // Grounded bodies still pick up a frame of gravity every other tick, so for
+  // them we only care about horizontal velocity.
+  const bool grounded = body.affected_by_gravity and body.collides_with_level
+      and body.position.y <= HeightFromMap(body.position);
+  const bool supported = grounded or not body.affected_by_gravity;
+  const bool still = body.velocity.x == 0_f and body.velocity.z == 0_f and
+      (grounded or body.velocity.y == 0_f) and
+      body.acceleration == Vec3{0_f, 0_f, 0_f} and
+      (body.position - old_position_[IdOf(body)]).Length2() < kRestDistance2;
+  if (supported and still) {
+    if (++body.still_ticks >= PHYSICS_SLEEP_TICKS) {
+      Sleep(&body);
+      sleeping_bodies_++;
+    }
+  } else {
+    body.still_ticks = 0;
+  }
+}
+
+int* World::IndexArray(IndexList list, int*& count) {
+  switch (list) {
+    case kPending:
+      count = &pending_bodies_;
+      return pending_;
+    case kActive:
+      count = &active_bodies_;
+      return active_;
+    case kPikmin:
+      count = &active_pikmin_;
+      return pikmin_;
+    case kImportant:
+      count = &important_bodies_;
+      return important_;
+    default:
+      count = nullptr;
+      return nullptr;
+  }
+}
+
+void World::AddToIndex(int id, IndexList list) {
+  int* count;
+  int* ids = IndexArray(list, count);
+  index_list_[id] = list;
+  index_slot_[id] = *count;
+  ids[(*count)++] = id;
+}
+
+void World::RemoveFromIndex(int id) {
+  int* count;
+  int* ids = IndexArray(index_list_[id], count);
+  if (ids == nullptr) {
+    return;
+  }
+  // Swap the last entry into this body's place; order within a list doesn't
+  // matter.
+  const int last = ids[--(*count)];
+  ids[index_slot_[id]] = last;
+  index_slot_[last] = index_slot_[id];
+  index_list_[id] = kUnindexed;
+}
+
+void World::IndexPendingBodies() {
+  while (pending_bodies_ > 0) {
+    const int id = pending_[pending_bodies_ - 1];
+    RemoveFromIndex(id);
+    if (bodies_[id].is_very_important) {
+      AddToIndex(id, kImportant);
+    } else if (bodies_[id].is_pikmin) {
+      AddToIndex(id, kPikmin);
+    } else {
+      AddToIndex(id, kActive);
+    }
+  }
+}
+
+static bool CylindersOverlap(const Vec3& a_position, fixed a_radius,
+                             fixed a_height, const Vec3& b_position,
+                             fixed b_radius, fixed b_height) {
   //Check to see if the circles overlap on the XZ plane
-  Vec2 axz = Vec2{a.position.x, a.position.z};
-  Vec2 bxz = Vec2{b.position.x, b.position.z};
+  Vec2 axz = Vec2{a_position.x, a_position.z};
+  Vec2 bxz = Vec2{b_position.x, b_position.z};
   auto distance2 = (axz - bxz).Length2();
-  auto sum = a.radius + b.radius;
+  auto sum = a_radius + b_radius;
   auto radius2 = sum * sum;
   if (distance2 < radius2) {
     //Check to see if their Y values are overlapping also
-    if (a.position.y + a.height >= b.position.y) {
-      if (b.position.y + b.height >= a.position.y) {
-        total_collisions_++;
+    if (a_position.y + a_height >= b_position.y) {
+      if (b_position.y + b_height >= a_position.y) {
         return true;
       }
     }
@@ -155,6 +498,19 @@ bool World::BodiesOverlap(Body& a, Body& b) {
   return false;
 }
 
+bool World::BodiesOverlap(Body& a, Body& b) {
+  if (&a == &b) {
+    return false; // Don't collide with yourself.
+  }
+  bodies_overlapping_++;
+  if (CylindersOverlap(a.position, a.radius, a.height,
+                       b.position, b.radius, b.height)) {
+    total_collisions_++;
+    return true;
+  }
+  return false;
+}
+
 void World::ResolveCollision(Body& a, Body& b) {
   // If either body is a sensor, then no collision response is
   // performed (objects pass right through) so we bail early
@@ -190,6 +546,7 @@ void World::ResolveCollision(Body& a, Body& b) {
       a_direction *= 1_f / distance;
 
       a.position = a.position + a_direction;
+      Wake(&a);
     }
     if (b.is_movable and (!(a.is_pikmin) or b.is_pikmin)) {
       auto b_direction = (b.position - a.position);
@@ -209,18 +566,14 @@ void World::ResolveCollision(Body& a, Body& b) {
       b_direction *= 1_f / distance;
 
       b.position = b.position + b_direction;
+      Wake(&b);
     }
   }
 }
 
 void World::PrepareBody(Body& body) {
   //set the old position (used later for comparison)
-  body.old_position = body.position;
-  body.old_radius = body.radius;
-
-  //clear sensor results for this run
-  body.result_groups = 0;
-  body.num_results = 0;
+  old_position_[IdOf(body)] = body.position;
 }
 
 void World::MoveBody(Body& body) {
@@ -235,18 +588,27 @@ void World::MoveBody(Body& body) {
 
 void World::MoveBodies() {
   for (int i = 0; i < active_bodies_; i++) {
-    // First, make sure this is an active body
-    PrepareBody(bodies_[active_[i]]);
-    MoveBody(bodies_[active_[i]]);
+    Body& body = bodies_[active_[i]];
+    WakeIfDisturbed(body);
+    PrepareBody(body);
+    if (not body.sleeping) {
+      MoveBody(body);
+    }
   }
   for (int i = 0; i < active_pikmin_; i++) {
-    // First, make sure this is an active body
-    PrepareBody(bodies_[pikmin_[i]]);
-    MoveBody(bodies_[pikmin_[i]]);
+    Body& body = bodies_[pikmin_[i]];
+    WakeIfDisturbed(body);
+    PrepareBody(body);
+    if (not body.sleeping) {
+      MoveBody(body);
+    }
   }
 }
 
 void World::CollideObjectWithObject(Body& A, Body& B) {
+  if (A.sleeping and B.sleeping) {
+    return;  // Nothing has changed between these two since they fell asleep
+  }
   const bool a_senses_b = B.is_sensor and
       (B.collision_group & A.sensor_groups);
   const bool b_senses_a = A.is_sensor and
@@ -261,166 +623,304 @@ void World::CollideObjectWithObject(Body& A, Body& B) {
 
       //if A is a sensor that B cares about
       if (A.collision_group & B.sensor_groups) {
-        B.result_groups = B.result_groups | A.collision_group;
-        if (B.num_results < 8) {
-          B.collision_results[B.num_results++] = {&A, A.collision_group};
-        }
+        AddContact(B, &A, A.collision_group, cold_[IdOf(A)].handle);
       }
       //if B is a sensor that A cares about
       if (B.collision_group & A.sensor_groups) {
-        A.result_groups = A.result_groups | B.collision_group;
-        if (A.num_results < 8) {
-          A.collision_results[A.num_results++] = {&B, B.collision_group};
-        }
+        AddContact(A, &B, B.collision_group, cold_[IdOf(B)].handle);
       }
     }
   }
 }
 
 void World::CollidePikminWithObject(Body& P, Body& A) {
+  if (P.sleeping and A.sleeping) {
+    return;
+  }
   if ((A.is_sensor and (A.collision_group & P.sensor_groups)) or
       (not A.is_sensor)) {
     if (BodiesOverlap(A, P)) {
       ResolveCollision(A, P);
       if (A.collision_group & P.sensor_groups) {
-        P.result_groups = P.result_groups | A.collision_group;
-        if (P.num_results < 8) {
-          P.collision_results[P.num_results++] = {&A, A.collision_group};
-        }
+        AddContact(P, &A, A.collision_group, cold_[IdOf(A)].handle);
       }
     }
   }
 }
 
+void World::CollideBodyWithTrigger(Body& body, AreaTrigger& trigger) {
+  if (trigger.collision_group & body.sensor_groups) {
+    bodies_overlapping_++;
+    if (CylindersOverlap(body.position, body.radius, body.height,
+                         trigger.position, trigger.radius, trigger.height)) {
+      total_collisions_++;
+      AddContact(body, trigger.anchor_body, trigger.collision_group,
+                 trigger.handle);
+    }
+  }
+}
+
 void World::CollidePikminWithPikmin(Body& pikmin1, Body& pikmin2) {
-  if ((int)pikmin1.position.x == (int)pikmin2.position.x and
-      (int)pikmin1.position.z == (int)pikmin2.position.z) {
-    if (BodiesOverlap(pikmin1, pikmin2)) {
-      ResolveCollision(pikmin1, pikmin2);
-    }
-  }
-}
-
-void World::AddNeighborToObject(Body& object, Body& new_neighbor) {
-  // calculate the distance *squared* between this object and the current
-  // candidate for neighbor status
-  fixed distance = (object.position - new_neighbor.position).Length2();
-  // Adjust for the radius on both sides (we want the distance between the
-  // nearest potential edge collision)
-  //distance -= (object.radius + new_neighbor.radius);
-  // Loop through the list of neighbors and find the farthest away object
-  // that this object is closer than (if any). If we find an inactive slot,
-  // we bail early; it wins.
-  fixed biggest_valid_distance = -1000_f;
-  int farthest_index = -1;
-  for (int i = 0; i < MAX_PHYSICS_NEIGHBORS; i++) {
-    if (object.neighbors[i].handle.IsValid()) {
-      auto current_body = object.neighbors[i].handle.body;
-      // If this object already exists in the list
-      if (&new_neighbor == current_body) {
-        // Update this distance and STOP.
-        object.neighbors[i].distance = distance;
-        return;
-      }
-      // Are we closer than this object, and is this object the farthest
-      // object we could replace?
-      if (object.neighbors[i].distance > distance and
-          object.neighbors[i].distance > biggest_valid_distance) {
-          farthest_index = i;
-          biggest_valid_distance = distance;
+  if (pikmin1.sleeping and pikmin2.sleeping) {
+    return;
+  }
+  if (BodiesOverlap(pikmin1, pikmin2)) {
+    ResolveCollision(pikmin1, pikmin2);
+  }
+}
+
+// Pairs that share more than one cell would otherwise be found once per shared
+// cell; only the cell at the low corner of the overlap gets to report them.
+static bool IsFirstSharedCell(int x, int z, const physics::CellBounds& a,
+                              const physics::CellBounds& b) {
+  return x == (a.min_x > b.min_x ? a.min_x : b.min_x) and
+         z == (a.min_z > b.min_z ? a.min_z : b.min_z);
+}
+
+// Grid ids past the end of the body table refer to area triggers.
+static bool IsTriggerId(int id) {
+  return id >= MAX_PHYSICS_BODIES;
+}
+
+void World::ReserveGridCells(int id, const Vec3& position, fixed radius) {
+  cell_bounds_[id] = grid_.BoundsFor(position, radius);
+  if (grid_.Reserve(cell_bounds_[id])) {
+    gridded_[gridded_bodies_++] = id;
+  } else {
+    overflow_[overflow_bodies_++] = id;
+  }
+}
+
+void World::RebuildGrid() {
+  // Pikmin are kept out of the grid; they only ever query it. Everything else
+  // (including very important bodies and area triggers) is bucketed by the
+  // cells it covers.
+  grid_.Clear();
+  gridded_bodies_ = 0;
+  overflow_bodies_ = 0;
+  for (int i = 0; i < active_bodies_; i++) {
+    Body& body = bodies_[active_[i]];
+    ReserveGridCells(active_[i], body.position, body.radius);
+  }
+  for (int i = 0; i < important_bodies_; i++) {
+    Body& body = bodies_[important_[i]];
+    ReserveGridCells(important_[i], body.position, body.radius);
+  }
+  for (int t = 0; t < MAX_AREA_TRIGGERS; t++) {
+    AreaTrigger& trigger = triggers_[t];
+    if (not (trigger.active and trigger.enabled)) {
+      continue;
+    }
+    trigger.anchor_body = nullptr;
+    if (trigger.anchor.type != World::kNone) {
+      trigger.anchor_body = RetrieveBody(trigger.anchor);
+      if (trigger.anchor_body == nullptr) {
+        continue;  // Our anchor is gone, so there's nowhere to be
       }
-    } else {
-      // Note: we don't short-circuit here because if we did, we might miss
-      // a chance to find ourselves in the list. We need to look at every
-      // neighbor to avoid that scenario.
-      farthest_index = i;
-      biggest_valid_distance = 1000_f;
+      trigger.position = trigger.anchor_body->position;
     }
+    ReserveGridCells(MAX_PHYSICS_BODIES + t, trigger.position, trigger.radius);
   }
-  if (farthest_index > -1) {
-    object.neighbors[farthest_index].handle = new_neighbor.GetHandle();
-    object.neighbors[farthest_index].distance = distance;
+  grid_.Finalize();
+  for (int i = 0; i < gridded_bodies_; i++) {
+    grid_.Insert(gridded_[i], cell_bounds_[gridded_[i]]);
   }
 }
 
-void World::UpdateNeighbors() {
-  // It's a bit weird that we do this check first, non? But it handles the
-  // case where bodies were deleted, moving the pointer off the end of the list.
-  if (current_neighbor_ >= active_bodies_) {
-    current_neighbor_ = 0;
+void World::CollideGridPair(int a, int b) {
+  if (IsTriggerId(a)) {
+    if (not IsTriggerId(b)) {
+      CollideBodyWithTrigger(bodies_[b], triggers_[a - MAX_PHYSICS_BODIES]);
+    }
+  } else if (IsTriggerId(b)) {
+    CollideBodyWithTrigger(bodies_[a], triggers_[b - MAX_PHYSICS_BODIES]);
+  } else {
+    CollideObjectWithObject(bodies_[a], bodies_[b]);
   }
+}
 
-  Body& new_neighbor = bodies_[active_[current_neighbor_]];
-  for (int a = 0; a < active_bodies_; a++) {
-    Body& current_object = bodies_[active_[a]];
-    if (&new_neighbor != &current_object) {
-      AddNeighborToObject(current_object, new_neighbor);
+void World::CollideObjectsWithObjects() {
+  for (int i = 0; i < gridded_bodies_; i++) {
+    const int a = gridded_[i];
+    const CellBounds& bounds = cell_bounds_[a];
+    for (int z = bounds.min_z; z <= bounds.max_z; z++) {
+      for (int x = bounds.min_x; x <= bounds.max_x; x++) {
+        for (auto entry = grid_.Begin(x, z); entry != grid_.End(x, z); entry++) {
+          // Each pair is visited from both sides; only the lower id acts.
+          const int b = entry->body;
+          if (b <= a or entry->x != x or entry->z != z) {
+            continue;
+          }
+          if (IsFirstSharedCell(x, z, bounds, cell_bounds_[b])) {
+            CollideGridPair(a, b);
+          }
+        }
+      }
     }
   }
 
-  for (int p = 0; p < active_pikmin_; p++) {
-    Body& current_object = bodies_[pikmin_[p]];
-    AddNeighborToObject(current_object, new_neighbor);
+  // Bodies that didn't fit in the grid fall back to brute force, so a full
+  // grid costs time rather than missed collisions.
+  for (int o = 0; o < overflow_bodies_; o++) {
+    for (int i = 0; i < gridded_bodies_; i++) {
+      CollideGridPair(overflow_[o], gridded_[i]);
+    }
+    for (int i = o + 1; i < overflow_bodies_; i++) {
+      CollideGridPair(overflow_[o], overflow_[i]);
+    }
   }
-  current_neighbor_++;
 }
 
-void World::ProcessCollision() {
-  UpdateNeighbors();
+void World::CollidePikminWithGridEntry(Body& P, int id) {
+  if (IsTriggerId(id)) {
+    CollideBodyWithTrigger(P, triggers_[id - MAX_PHYSICS_BODIES]);
+  } else {
+    CollidePikminWithObject(P, bodies_[id]);
+  }
+}
 
-  debug::Profiler::StartTopic(tAA);
-  for (int a = 0; a < active_bodies_; a++) {
-    Body& A = bodies_[active_[a]];
-    for (int b = 0; b < MAX_PHYSICS_NEIGHBORS; b++) {
-      BodyHandle B = A.neighbors[b].handle;
-      if (B.IsValid()) {
-        CollideObjectWithObject(A, *(B.body));
+void World::CollidePikminWithObjects() {
+  for (int p = 0; p < active_pikmin_; p++) {
+    Body& P = bodies_[pikmin_[p]];
+    const CellBounds bounds = grid_.BoundsFor(P.position, P.radius);
+    for (int z = bounds.min_z; z <= bounds.max_z; z++) {
+      for (int x = bounds.min_x; x <= bounds.max_x; x++) {
+        for (auto entry = grid_.Begin(x, z); entry != grid_.End(x, z); entry++) {
+          if (entry->x != x or entry->z != z) {
+            continue;
+          }
+          if (IsFirstSharedCell(x, z, bounds, cell_bounds_[entry->body])) {
+            CollidePikminWithGridEntry(P, entry->body);
+          }
+        }
       }
     }
-    for (int i = 0; i < important_bodies_; i++) {
-      CollideObjectWithObject(A, bodies_[important_[i]]);
+    for (int o = 0; o < overflow_bodies_; o++) {
+      CollidePikminWithGridEntry(P, overflow_[o]);
     }
   }
-  debug::Profiler::EndTopic(tAA);
+}
 
-  // Repeat this with pikmin, our special case heros
-  // Pikmin need to collide against all active bodies, but not with each other*
-  //   *except sometimes
-  debug::Profiler::StartTopic(tAP);
+static_assert(MAX_PHYSICS_BODIES <= MAX_PHYSICS_GRID_ENTRIES,
+    "Every pikmin must fit in the pikmin grid");
+
+void World::CollidePikminWithPikmin() {
+  // Counting sort the pikmin by cell. Cells are at least as wide as a pikmin,
+  // so anything a pikmin overlaps is in its own cell or a neighboring one.
+  pikmin_grid_.Clear();
+  for (int p = 0; p < active_pikmin_; p++) {
+    Body& P = bodies_[pikmin_[p]];
+    pikmin_grid_.Reserve(pikmin_grid_.BoundsFor(P.position, 0_f));
+  }
+  pikmin_grid_.Finalize();
   for (int p = 0; p < active_pikmin_; p++) {
     Body& P = bodies_[pikmin_[p]];
-    for (int a = 0; a < MAX_PHYSICS_NEIGHBORS; a++) {
-      BodyHandle A = P.neighbors[a].handle;;
-      if (A.IsValid()) {
-        CollidePikminWithObject(P, *(A.body));
+    pikmin_grid_.Insert(pikmin_[p], pikmin_grid_.BoundsFor(P.position, 0_f));
+  }
+
+  for (int p = 0; p < active_pikmin_; p++) {
+    const int a = pikmin_[p];
+    Body& P1 = bodies_[a];
+    const CellBounds cell = pikmin_grid_.BoundsFor(P1.position, 0_f);
+    for (int z = cell.min_z - 1; z <= cell.max_z + 1; z++) {
+      for (int x = cell.min_x - 1; x <= cell.max_x + 1; x++) {
+        for (auto entry = pikmin_grid_.Begin(x, z);
+             entry != pikmin_grid_.End(x, z); entry++) {
+          // Each pair is visited from both sides; only the lower id acts.
+          if (entry->body <= a or entry->x != x or entry->z != z) {
+            continue;
+          }
+          CollidePikminWithPikmin(P1, bodies_[entry->body]);
+        }
       }
     }
-    for (int i = 0; i < important_bodies_; i++) {
-      CollidePikminWithObject(P, bodies_[important_[i]]);
+  }
+}
+
+int World::QueryCylinder(Vec3 center, fixed radius, fixed height,
+                         u32 group_mask, Body** results, int max_results) {
+  // Note: this uses the grid as of the last physics tick, so bodies that
+  // teleported since then may be missed.
+  int num_results = 0;
+  // Collision response and the level can push bodies a little after the grid
+  // is built, so look one cell further out than the cylinder reaches.
+  CellBounds bounds = grid_.BoundsFor(center, radius);
+  bounds.min_x--;
+  bounds.min_z--;
+  bounds.max_x++;
+  bounds.max_z++;
+  for (int z = bounds.min_z; z <= bounds.max_z; z++) {
+    for (int x = bounds.min_x; x <= bounds.max_x; x++) {
+      for (auto entry = grid_.Begin(x, z); entry != grid_.End(x, z); entry++) {
+        const int id = entry->body;
+        if (IsTriggerId(id) or entry->x != x or entry->z != z or
+            not IsFirstSharedCell(x, z, bounds, cell_bounds_[id])) {
+          continue;
+        }
+        Body& body = bodies_[id];
+        if (body.active and (body.collision_group & group_mask) and
+            CylindersOverlap(center, radius, height,
+                             body.position, body.radius, body.height)) {
+          if (num_results >= max_results) {
+            return num_results;
+          }
+          results[num_results++] = &body;
+        }
+      }
     }
   }
-  debug::Profiler::EndTopic(tAP);
 
-  // Finally, collide 1/8 of the pikmin against the rest of the group.
-  // (This really doesn't need to be terribly accurate.)
-  debug::Profiler::StartTopic(tPP);
-  for (int p1 = iteration %  8; p1 < active_pikmin_; p1 += 8) {
-    Body& P1 = bodies_[pikmin_[p1]];
-    for (int p2 = 0; p2 < active_pikmin_; p2++) {
-      Body& P2 = bodies_[pikmin_[p2]];
-      CollidePikminWithPikmin(P1, P2);
+  // Pikmin and anything that overflowed the grid are checked directly.
+  for (int i = 0; i < active_pikmin_ + overflow_bodies_; i++) {
+    const int id = i < active_pikmin_ ? pikmin_[i] : overflow_[i - active_pikmin_];
+    if (IsTriggerId(id)) {
+      continue;
+    }
+    Body& body = bodies_[id];
+    if (body.active and (body.collision_group & group_mask) and
+        CylindersOverlap(center, radius, height,
+                         body.position, body.radius, body.height)) {
+      if (num_results >= max_results) {
+        return num_results;
+      }
+      results[num_results++] = &body;
     }
   }
+  return num_results;
+}
+
+void World::ProcessCollision() {
+  debug::Profiler::StartTopic(tBroadphase);
+  RebuildGrid();
+  debug::Profiler::EndTopic(tBroadphase);
+
+  debug::Profiler::StartTopic(tAA);
+  CollideObjectsWithObjects();
+  debug::Profiler::EndTopic(tAA);
+
+  // Repeat this with pikmin, our special case heros
+  // Pikmin need to collide against all active bodies, but not with each other*
+  //   *except sometimes
+  debug::Profiler::StartTopic(tAP);
+  CollidePikminWithObjects();
+  debug::Profiler::EndTopic(tAP);
+
+  // Finally, keep the pikmin from piling up on top of each other.
+  debug::Profiler::StartTopic(tPP);
+  CollidePikminWithPikmin();
   debug::Profiler::EndTopic(tPP);
+
+  debug::Profiler::StartTopic(tContacts);
+  UpdateContacts();
+  debug::Profiler::EndTopic(tContacts);
 }
 
 void World::Update() {
   bodies_overlapping_ = 0;
   total_collisions_ = 0;
-  if (rebuild_index_) {
-    RebuildIndex();
-  }
-  
+  dropped_contacts_ = 0;
+  IndexPendingBodies();
+
   debug::Profiler::StartTopic(tMoveBodies);
   MoveBodies();
   debug::Profiler::EndTopic(tMoveBodies);
@@ -433,7 +933,7 @@ void World::Update() {
   CollideBodiesWithLevel();
   debug::Profiler::EndTopic(tCollideWorld);
 
-  iteration++;
+  UpdateSleepStates();
 }
 
 int World::BodiesOverlapping() {
@@ -444,6 +944,14 @@ int World::TotalCollisions() {
   return total_collisions_;
 }
 
+int World::SleepingBodies() {
+  return sleeping_bodies_;
+}
+
+int World::DroppedContacts() {
+  return dropped_contacts_;
+}
+
 void World::DebugCircles() {
   for (int i = 0; i < active_bodies_; i++) {
     Body& body = bodies_[active_[i]];
@@ -454,12 +962,18 @@ void World::DebugCircles() {
     if (body.is_sensor) {
       color = RGB5(31,31,0); //yellow for sensors
     }
+    if (body.sleeping) {
+      color = RGB5(10,10,20); //dim blue for sleeping bodies
+    }
     debug::DrawCircle(body.position, body.radius, color, segments);
   }
   for (int i = 0; i < active_pikmin_; i++) {
     Body& body = bodies_[pikmin_[i]];
     //pick a color based on the state of this body
     rgb color = RGB5(31,15,15);
+    if (body.sleeping) {
+      color = RGB5(15,7,15);
+    }
     int segments = 6;
     debug::DrawCircle(body.position, body.radius, color, segments);
   }
@@ -472,27 +986,33 @@ void World::DebugCircles() {
     debug::DrawCircle(body.position, body.radius, color, segments);
   }
 
-  // Draw relationships from the current neighbor
-  Body& A = bodies_[active_[current_neighbor_]];
-  for (int i = 0; i < MAX_PHYSICS_NEIGHBORS; i++) {
-    BodyHandle B = A.neighbors[i].handle;
-    if (B.IsValid()) {
-        debug::DrawLine(A.position, B.body->position, RGB5(0, 31, 0));
+  for (int t = 0; t < MAX_AREA_TRIGGERS; t++) {
+    AreaTrigger& trigger = triggers_[t];
+    if (trigger.active and trigger.enabled) {
+      debug::DrawCircle(trigger.position, trigger.radius, RGB5(31,20,0), 12);
     }
   }
 }
 
 void World::CollideBodiesWithLevel() {
   for (int i = 0; i < active_bodies_; i++) {
-    // First, make sure this is an active body
     CollideBodyWithLevel(bodies_[active_[i]]);
   }
   for (int i = 0; i < active_pikmin_; i++) {
-    // First, make sure this is an active body
     CollideBodyWithLevel(bodies_[pikmin_[i]]);
   }
 }
 
+void World::UpdateSleepStates() {
+  sleeping_bodies_ = 0;
+  for (int i = 0; i < active_bodies_; i++) {
+    UpdateSleepState(bodies_[active_[i]]);
+  }
+  for (int i = 0; i < active_pikmin_; i++) {
+    UpdateSleepState(bodies_[pikmin_[i]]);
+  }
+}
+
 void World::GenerateHeightTable() {
   fixed height_step = 32_f / 128_f;
   for (int i = 0; i < 128; i++) {
@@ -505,11 +1025,32 @@ void World::SetHeightmap(const u8* raw_heightmap_data) {
   int* heightmap_coords = (int*)raw_heightmap_data;
   heightmap_width = heightmap_coords[0];
   heightmap_height = heightmap_coords[1];
+
+  const int cells = heightmap_width * heightmap_height;
+  wall_field = heightmap_data + cells;
+  terrain_attributes = wall_field + cells;
+
+  // The layer section is padded out to a 4 byte boundary
+  int layer_offset = 8 + cells * 3;
+  layer_offset = (layer_offset + 3) & ~3;
+  u32 layer_bytes = *(u32*)(raw_heightmap_data + layer_offset);
+  if (layer_bytes > 0) {
+    layer_index = (u16*)(raw_heightmap_data + layer_offset + 4);
+    layer_data = (u8*)(layer_index + cells);
+  } else {
+    layer_index = nullptr;
+    layer_data = nullptr;
+  }
   GenerateHeightTable();
 }
 
+// Set on a cell's ground height when it has more layers above the ground.
+const u8 kHasLayers = 0x80;
+
+const fixed kWallThreshold = 2_f; //this seems reasonable
+
 // Given a world position, figured out the level's height within the loaded
-// height map
+// height map. Note that this is always the ground, ignoring any extra layers.
 fixed World::HeightFromMap(int hx, int hz) {
   if (hx < 0) {hx = 0;}
   if (hz < 0) {hz = 0;}
@@ -521,24 +1062,116 @@ fixed World::HeightFromMap(int hx, int hz) {
 }
 
 fixed World::HeightFromMap(const Vec3& position) {
+  return SurfaceAt(position, nullptr);
+}
+
+u8 World::TerrainAt(const Vec3& position) {
+  u8 attributes;
+  SurfaceAt(position, &attributes);
+  return attributes;
+}
+
+fixed World::SurfaceAt(const Vec3& position, u8* attributes) {
   // Figure out the body's "pixel" within the heightmap; we simply clamp to
   // integers to do this since one pixel is equivalent to one unit in the world
   int hx = (int)position.x;
   int hz = (int)position.z;
 
   // Clamp the positions to the map edges, so we don't get weirdness
+  if (hx < 0) {hx = 0;}
+  if (hz < 0) {hz = 0;}
+  if (hx >= heightmap_width) {hx = heightmap_width - 1;}
+  if (hz >= heightmap_height) {hz = heightmap_height - 1;}
+
+  const int cell = hz * heightmap_width + hx;
+  const u8 ground = heightmap_data[cell];
+  fixed height = height_table_[ground & 0x7F];
+  if (attributes) {
+    *attributes = terrain_attributes[cell];
+  }
+
+  if (ground & kHasLayers) {
+    // Layers are sorted from the bottom up. Stand on the highest one that
+    // isn't above us, allowing for the same step up a wall would; anything
+    // higher is an overhang we're walking underneath.
+    const u8* layer = layer_data + layer_index[cell];
+    const int count = *layer++;
+    for (int i = 0; i < count; i++, layer += 2) {
+      const fixed layer_height = height_table_[layer[0] & 0x7F];
+      if (layer_height > position.y + kWallThreshold) {
+        break;
+      }
+      height = layer_height;
+      if (attributes) {
+        *attributes = layer[1];
+      }
+    }
+  }
+  return height;
+}
+
+// Tall enough that nothing can ever get over it
+const fixed kWallTileHeight = fixed::FromInt(1024);
+
+// The ground height, as far as walls are concerned; tiles marked as walls
+// can't be walked into from any height.
+fixed World::WallHeight(int hx, int hz) {
+  if (hx < 0) {hx = 0;}
+  if (hz < 0) {hz = 0;}
+  if (hx >= heightmap_width) {hx = heightmap_width - 1;}
+  if (hz >= heightmap_height) {hz = heightmap_height - 1;}
+
+  if (terrain_attributes[hz * heightmap_width + hx] & kTerrainWall) {
+    return kWallTileHeight;
+  }
   return HeightFromMap(hx, hz);
 }
 
-const fixed kWallThreshold = 2_f; //this seems reasonable
+// Wall field layout, one byte per tile. The low nibble flags which of the
+// tile's edges are walls, ie the tile across that edge is more than
+// kWallThreshold higher than this one. The high nibble is the distance in
+// tiles to the nearest tile with a wall edge, saturating at 15. This must
+// match tools/image-to-heightmap.py.
+const u8 kWallPositiveX = 0x1;
+const u8 kWallNegativeX = 0x2;
+const u8 kWallPositiveZ = 0x4;
+const u8 kWallNegativeZ = 0x8;
+
+u8 World::WallField(int hx, int hz) {
+  if (hx < 0 or hz < 0 or hx >= heightmap_width or hz >= heightmap_height) {
+    // Tiles off the edge of the map copy the heights at the edge, walls and
+    // all. This is rare enough to just work out by hand; the clamped distance
+    // can only underestimate, which is safe.
+    const fixed height = WallHeight(hx, hz);
+    u8 edges = 0;
+    if (WallHeight(hx + 1, hz) - height > kWallThreshold) {
+      edges |= kWallPositiveX;
+    }
+    if (WallHeight(hx - 1, hz) - height > kWallThreshold) {
+      edges |= kWallNegativeX;
+    }
+    if (WallHeight(hx, hz + 1) - height > kWallThreshold) {
+      edges |= kWallPositiveZ;
+    }
+    if (WallHeight(hx, hz - 1) - height > kWallThreshold) {
+      edges |= kWallNegativeZ;
+    }
+    if (hx < 0) {hx = 0;}
+    if (hz < 0) {hz = 0;}
+    if (hx >= heightmap_width) {hx = heightmap_width - 1;}
+    if (hz >= heightmap_height) {hz = heightmap_height - 1;}
+    return (wall_field[hz * heightmap_width + hx] & 0xF0) | edges;
+  }
+  return wall_field[hz * heightmap_width + hx];
+}
 
 void World::CollideBodyWithLevel(Body& body) {
-  if (!body.collides_with_level) {
+  if (!body.collides_with_level or body.sleeping) {
     return;
   }
 
   if (!(body.ignores_walls)) {
-    CollideBodyWithTilemap(body, 4);
+    CollideBodyWithTilemap(body);
   }
 
   fixed current_level_height = HeightFromMap(body.position);
@@ -551,114 +1184,82 @@ void World::CollideBodyWithLevel(Body& body) {
   }
 }
 
-void World::CollideBodyWithTilemap(Body& body, int max_depth) {
-  // Note: tiles are 1 "unit" wide for collision purposes. This simplifies life.
-  int tile_diff_x = ((int)body.position.x - (int)body.old_position.x);
-  int tile_diff_z = ((int)body.position.z - (int)body.old_position.z);
-  int tiles_traversed = abs(tile_diff_x) + abs(tile_diff_z) + 1;
+void World::CollideBodyWithTilemap(Body& body) {
+  const Vec3& old_position = old_position_[IdOf(body)];
 
-  if (tiles_traversed <= 1) {
-    // Early out: we didn't leave our starting tile this frame
+  // Note: tiles are 1 "unit" wide for collision purposes. This simplifies life.
+  int tile_x = (int)old_position.x;
+  int tile_z = (int)old_position.z;
+  int target_x = (int)body.position.x;
+  int target_z = (int)body.position.z;
+  int tiles_traversed = abs(target_x - tile_x) + abs(target_z - tile_z);
+
+  // Early out: we can't cross a wall edge without first reaching a tile that
+  // has one, and that's further away than we moved this frame. This also
+  // covers staying within our starting tile.
+  if (tiles_traversed <= (WallField(tile_x, tile_z) >> 4)) {
     return;
   }
 
-  // Figure out our first intersection and step size for traversing the grid
-  Vec3 diff = body.old_position - body.position;
-
-  fixed intersect_x_step, intersect_z_step, next_intersect_x, next_intersect_z;
-  if (diff.x == 0_f) {
-    intersect_x_step = 0_f;
-    next_intersect_x = fixed::FromRaw(0x0FFFFFFF); // Effectively positive infinity
-  } else {
-    fixed x_fraction = body.position.x - fixed::FromInt((int)body.position.x);
-    if (diff.x > 0_f) {
-      intersect_x_step = 1_f / diff.x;
-      next_intersect_x = (1_f - x_fraction) * intersect_x_step;
+  // Walk the tiles along our path, picking whichever axis crosses its next
+  // tile boundary first. Comparing crossing times by cross multiplying keeps
+  // this free of divisions.
+  Vec3 diff = body.position - old_position;
+  fixed distance_x = diff.x < 0_f ? -diff.x : diff.x;
+  fixed distance_z = diff.z < 0_f ? -diff.z : diff.z;
+  int step_x = (target_x > tile_x ? 1 : -1);
+  int step_z = (target_z > tile_z ? 1 : -1);
+  fixed boundary_x = step_x > 0 ?
+      fixed::FromInt(tile_x + 1) - old_position.x :
+      old_position.x - fixed::FromInt(tile_x);
+  fixed boundary_z = step_z > 0 ?
+      fixed::FromInt(tile_z + 1) - old_position.z :
+      old_position.z - fixed::FromInt(tile_z);
+
+  while (tile_x != target_x or tile_z != target_z) {
+    bool moved_x;
+    if (tile_x == target_x) {
+      moved_x = false;
+    } else if (tile_z == target_z) {
+      moved_x = true;
     } else {
-      intersect_x_step = -1_f / diff.x;
-      next_intersect_x = x_fraction * intersect_x_step;
+      moved_x = boundary_x * distance_z < boundary_z * distance_x;
     }
-  }
 
-  if (diff.z == 0_f) {
-    intersect_z_step = 0_f;
-    next_intersect_z = fixed::FromRaw(0x0FFFFFFF); // Effectively positive infinity
-  } else {
-    fixed z_fraction = body.position.z - fixed::FromInt((int)body.position.z);
-    if (diff.z > 0_f) {
-      intersect_z_step = 1_f / diff.z;
-      next_intersect_z = (1_f - z_fraction) * intersect_z_step;
+    u8 edge;
+    if (moved_x) {
+      edge = step_x > 0 ? kWallPositiveX : kWallNegativeX;
     } else {
-      intersect_z_step = -1_f / diff.z;
-      next_intersect_z = z_fraction * intersect_z_step;
+      edge = step_z > 0 ? kWallPositiveZ : kWallNegativeZ;
     }
-  }
-
-  // Now, iterate over all the tiles this object would intersect, and perform height checks as we go
-  int tile_x = (int)body.old_position.x;
-  int tile_z = (int)body.old_position.z;
-
-  int step_x = (tile_diff_x > 0 ? 1 : -1);
-  int step_z = (tile_diff_z > 0 ? 1 : -1);
-  bool moved_x;
-
-  fixed current_level_height = HeightFromMap(body.old_position);
-
-  for (int i = 1; i < tiles_traversed; i++) {
-    if (next_intersect_x < next_intersect_z) {
-      tile_x += step_x;
-      next_intersect_x += intersect_x_step;
-      moved_x = true;
-    } else {
-      tile_z += step_z;
-      next_intersect_z += intersect_z_step;
-      moved_x = false;
+    const int next_x = moved_x ? tile_x + step_x : tile_x;
+    const int next_z = moved_x ? tile_z : tile_z + step_z;
+
+    if ((WallField(tile_x, tile_z) & edge) and
+        body.position.y < WallHeight(next_x, next_z)) {
+      // Wall collision here! Project our movement onto the wall, by pinning
+      // the blocked axis to our side of the edge, and keep sliding along the
+      // other one.
+      if (moved_x) {
+        body.position.x = step_x > 0 ?
+            fixed::FromInt(tile_x + 1) - fixed::FromRaw(1) :
+            fixed::FromInt(tile_x);
+        target_x = tile_x;
+      } else {
+        body.position.z = step_z > 0 ?
+            fixed::FromInt(tile_z + 1) - fixed::FromRaw(1) :
+            fixed::FromInt(tile_z);
+        target_z = tile_z;
+      }
+      continue;
     }
 
-    // Check to see if this is a valid move, and otherwise handle the response
-    fixed new_level_height = HeightFromMap(tile_x, tile_z);
-    if (body.position.y < new_level_height) {
-      if (new_level_height - current_level_height > kWallThreshold) {
-        // Wall collision here!
-        Vec3 intersection;
-        Vec3 new_position;
-        if (moved_x) {
-          fixed x_moved = next_intersect_x - intersect_x_step;          
-          intersection.x = body.old_position.x + (diff.x * x_moved);
-          intersection.y = body.old_position.y + (diff.y * x_moved);
-          intersection.z = body.old_position.z + (diff.z * x_moved);
-
-          new_position.x = intersection.x;
-          new_position.y = body.position.y;
-          new_position.z = body.position.z;
-        } else {          
-          fixed z_moved = next_intersect_z - intersect_z_step;
-          intersection.x = body.old_position.x + (diff.x * z_moved);
-          intersection.y = body.old_position.y + (diff.y * z_moved);
-          intersection.z = body.old_position.z + (diff.z * z_moved);
-
-          new_position.x = body.position.x;
-          new_position.y = body.position.y;
-          new_position.z = intersection.z;
-        }
-
-        body.old_position = intersection;
-        body.position = new_position;
-
-        if (max_depth > 1) {
-          CollideBodyWithTilemap(body, max_depth - 1);
-        }
-        return;
-      }
+    tile_x = next_x;
+    tile_z = next_z;
+    if (moved_x) {
+      boundary_x += 1_f;
+    } else {
+      boundary_z += 1_f;
     }
-    current_level_height = new_level_height;
   }
-
 }
-
-
-
-
-
-
-
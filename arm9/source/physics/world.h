@@ -1,7 +1,10 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include "area_trigger.h"
 #include "body.h"
+#include "contact.h"
+#include "grid.h"
 #include "project_settings.h"
 
 namespace physics {
@@ -12,6 +15,36 @@ class World {
     void FreeBody(Body* body);
     Body* RetrieveBody(Handle handle);
 
+    // Accessors for the cold half of a body allocated by this world.
+    Handle HandleOf(Body* body);
+    Handle Owner(Body* body);
+    void SetOwner(Body* body, Handle owner);
+
+    // Sensor contacts from the last tick, sorted by the sensing body. This
+    // includes contacts that ended during that tick.
+    const Contact* Contacts(int& count);
+    const Contact* ContactsFor(Body* body, int& count);
+    // First contact that began or persisted last tick in any of
+    // collision_mask. Returns an empty contact if there isn't one.
+    Contact FirstCollisionWith(Body* body, u32 collision_mask);
+    // Whether there is such a contact, from a mask kept up to date each tick;
+    // this is cheap enough to call from every guard.
+    bool Senses(Body* body, u32 collision_mask);
+
+    AreaTrigger* AllocateTrigger(Handle owner = Handle{});
+    void FreeTrigger(AreaTrigger* trigger);
+    AreaTrigger* RetrieveTrigger(Handle handle);
+
+    // Finds bodies in any of group_mask whose cylinders overlap this one.
+    // Writes up to max_results bodies and returns how many were found.
+    int QueryCylinder(Vec3 center, numeric_types::fixed radius,
+                      numeric_types::fixed height, u32 group_mask,
+                      Body** results, int max_results);
+
+    // Bodies fall asleep on their own once they come to rest. Anything that
+    // moves a body from outside the physics loop should wake it.
+    void Wake(physics::Body* body);
+
     void Update();
     void DebugCircles();
     void ResetWorld();
@@ -19,14 +52,27 @@ class World {
     // Metrics
     int BodiesOverlapping();
     int TotalCollisions();
+    int SleepingBodies();
+    int DroppedContacts();
 
     void SetHeightmap(const u8* raw_heightmap_data);
+
+    // Terrain attributes, stored per surface in the heightmap. These must
+    // match tools/image-to-heightmap.py.
+    enum TerrainAttribute : u8 {
+      kTerrainWater = 0x1,
+      kTerrainFire = 0x2,
+      kTerrainWall = 0x4,
+    };
+    // Attributes of the surface a body at this position would be standing on.
+    u8 TerrainAt(const Vec3& position);
     World();
     ~World();
 
     enum ObjectType {
       kNone = 0,
-      kBody
+      kBody,
+      kTrigger
     };
   private:
     bool BodiesOverlap(physics::Body& A, physics::Body& b);
@@ -35,24 +81,62 @@ class World {
     void PrepareBody(Body& body);
     void MoveBody(Body& body);
     void MoveBodies();
-    void RebuildIndex();
-    void Wake(physics::Body* body);
+    // Every slot is in exactly one of these lists. Allocated bodies wait in
+    // kPending until the next Update sorts them by their flags.
+    enum IndexList : u8 {
+      kFree = 0,
+      kUnindexed,
+      kPending,
+      kActive,
+      kPikmin,
+      kImportant
+    };
+    void ResetFreeList();
+    int* IndexArray(IndexList list, int*& count);
+    void AddToIndex(int id, IndexList list);
+    void RemoveFromIndex(int id);
+    void IndexPendingBodies();
+    int IdOf(const Body& body) const;
+    void AddContact(Body& body, Body* other, u32 collision_group,
+                    Handle handle);
+    void EmitContact(const Contact& contact, ContactPhase phase);
+    void LoseContact(const Contact& contact);
+    bool ContactStillAsleep(const Contact& contact);
+    void UpdateContacts();
+    void ResetContacts();
     void Sleep(physics::Body* body);
+    void WakeIfDisturbed(physics::Body& body);
+    void UpdateSleepState(physics::Body& body);
+    void UpdateSleepStates();
     void CollideBodyWithLevel(physics::Body& body);
     void CollideBodiesWithLevel();
-    void CollideBodyWithTilemap(physics::Body& body, int max_depth);
+    void CollideBodyWithTilemap(physics::Body& body);
     void CollideObjectWithObject(physics::Body& A, physics::Body& B);
     void CollidePikminWithObject(physics::Body& P, physics::Body& A);
     void CollidePikminWithPikmin(physics::Body& pikmin1, physics::Body& pikmin2);
-    void UpdateNeighbors();
-    void AddNeighborToObject(Body& object, Body& new_neighbor);
+    void ReserveGridCells(int id, const Vec3& position,
+                          numeric_types::fixed radius);
+    void CollideGridPair(int a, int b);
+    void CollidePikminWithGridEntry(physics::Body& P, int id);
+    void CollideBodyWithTrigger(physics::Body& body, AreaTrigger& trigger);
+    void RebuildGrid();
+    void CollideObjectsWithObjects();
+    void CollidePikminWithObjects();
+    void CollidePikminWithPikmin();
 
     numeric_types::fixed HeightFromMap(const Vec3& position);
     numeric_types::fixed HeightFromMap(int hx, int hz);
+    numeric_types::fixed SurfaceAt(const Vec3& position, u8* attributes);
+    numeric_types::fixed WallHeight(int hx, int hz);
+    u8 WallField(int hx, int hz);
     void GenerateHeightTable();
     numeric_types::fixed height_table_[128];
 
+    // Body storage is split by access pattern: the Body array holds only what
+    // the per-tick loops need, everything else sits in parallel tables.
     physics::Body bodies_[MAX_PHYSICS_BODIES];
+    physics::BodyColdData cold_[MAX_PHYSICS_BODIES];
+    Vec3 old_position_[MAX_PHYSICS_BODIES];
 
     int active_bodies_ = 0;
     int active_[MAX_PHYSICS_BODIES];
@@ -60,27 +144,66 @@ class World {
     int pikmin_[MAX_PHYSICS_BODIES];
     int important_bodies_ = 0;
     int important_[MAX_PHYSICS_BODIES];
+    int pending_bodies_ = 0;
+    int pending_[MAX_PHYSICS_BODIES];
+
+    // Per slot bookkeeping: which list the slot is in and where, plus the
+    // free list links for unallocated slots.
+    IndexList index_list_[MAX_PHYSICS_BODIES];
+    u16 index_slot_[MAX_PHYSICS_BODIES];
+    int next_free_[MAX_PHYSICS_BODIES];
+    int first_free_ = -1;
 
-    bool rebuild_index_ = true;
     int heightmap_width = 0;
     int heightmap_height = 0;
     u8* heightmap_data = nullptr;
+    // Precomputed by image-to-heightmap.py; see WallField
+    u8* wall_field = nullptr;
+    u8* terrain_attributes = nullptr;
+    // Cells flagged with kHasLayers have extra surfaces (bridges, overhangs)
+    // above the ground; layer_index gives the offset of their run in
+    // layer_data. Both are null for single layer maps.
+    u16* layer_index = nullptr;
+    u8* layer_data = nullptr;
 
-    int iteration = 0;
     int bodies_overlapping_ = 0;
     int total_collisions_ = 0;
-
-    int current_neighbor_ = 0;
-
-    int current_generation_ = 0;
+    int sleeping_bodies_ = 0;
+
+    // Broadphase. Bodies that don't fit in the grid are tested against
+    // everything instead.
+    // Grid ids are body ids, followed by area trigger ids.
+    Grid grid_;
+    CellBounds cell_bounds_[MAX_PHYSICS_BODIES + MAX_AREA_TRIGGERS];
+    int gridded_bodies_ = 0;
+    int gridded_[MAX_PHYSICS_BODIES + MAX_AREA_TRIGGERS];
+    int overflow_bodies_ = 0;
+    int overflow_[MAX_PHYSICS_BODIES + MAX_AREA_TRIGGERS];
+
+    AreaTrigger triggers_[MAX_AREA_TRIGGERS];
+
+    // Pikmin are bucketed separately, by the single cell their center is in.
+    Grid pikmin_grid_{PHYSICS_PIKMIN_CELL_SHIFT};
+
+    // Contacts found during this tick, in no particular order. These are
+    // sorted and matched against the previous tick's list to work out which
+    // ones began, persisted, or ended.
+    int new_contact_count_ = 0;
+    Contact new_contacts_[MAX_PHYSICS_CONTACTS];
+    int current_contacts_ = 0;
+    int contact_count_[2] = {0, 0};
+    Contact contacts_[2][MAX_PHYSICS_CONTACTS];
+    int dropped_contacts_ = 0;
 
     // Debug Topic IDs
     int tMoveBodies;
     int tCollideBodies;
     int tCollideWorld;
+    int tBroadphase;
     int tAA;
     int tAP;
     int tPP;
+    int tContacts;
 };
 
 }  // namespace physics
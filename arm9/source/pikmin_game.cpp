@@ -62,6 +62,9 @@ PikminGame::PikminGame(MultipassRenderer& renderer) : renderer_{renderer} {
   debug::RegisterFlag("Draw Renderer Circles");
   debug::RegisterFlag("Skip VBlank");
   debug::RegisterFlag("Render First Pass Only");
+  debug::RegisterFlag("Render Top to Bottom");
+  debug::RegisterFlag("Render Side to Side");
+  debug::RegisterFlag("Render Full Detail");
 
   debug::RegisterWorld(&world_);
   debug::RegisterRenderer(&renderer_);
@@ -70,6 +73,28 @@ PikminGame::PikminGame(MultipassRenderer& renderer) : renderer_{renderer} {
   tPhysicsUpdate = debug::Profiler::RegisterTopic("Game: Physics");
 
   ai_profilers_.emplace("Pikmin", debug::AiProfiler());
+
+  // AI runs on one step, physics and the renderer's own updates on the next.
+  // Slices within a step run in the order they're added.
+  const int kAiStep = 0;
+  const int kPhysicsStep = 1;
+  scheduler_.AddSlice(kAiStep, [this]() {
+    scanKeys();
+    ui::machine.RunLogic(ui_);
+  });
+  scheduler_.AddSlice(kAiStep, [this]() { RunCaptainAi(); });
+  const unsigned int kPikminPerSlice = 25;
+  for (unsigned int first = 0; first < pikmin.size(); first += kPikminPerSlice) {
+    scheduler_.AddSlice(kAiStep, [this, first, kPikminPerSlice]() {
+      RunPikminAi(first, first + kPikminPerSlice);
+    });
+  }
+  scheduler_.AddSlice(kAiStep, [this]() { RunObjectAi(); });
+  scheduler_.AddSlice(kAiStep, [this]() { RunCameraAi(); });
+  scheduler_.AddSlice(kPhysicsStep, [this]() { renderer_.Update(); });
+  scheduler_.AddSlice(kPhysicsStep, [this]() { UpdatePhysics(); });
+  scheduler_.SetStepTopic(kAiStep, tAI);
+  renderer_.SetScheduler(&scheduler_);
 }
 
 PikminGame::~PikminGame() {
@@ -402,10 +427,13 @@ void PikminGame::LoadLevel(std::string filename) {
   }
 }
 
-void PikminGame::RunAi() {
-  debug::Profiler::StartTopic(tAI);
+void PikminGame::RunCaptainAi() {
+  if (IsPaused()) {
+    return;
+  }
   for (auto i = captains.begin(); i != captains.end(); i++) {
     if (i->active) {
+      captain_ai::UpdateActiveOnion(*i);
       captain_ai::machine.RunLogic(*i);
       squad_ai::machine.RunLogic((*i).squad);
       i->Update();
@@ -416,9 +444,16 @@ void PikminGame::RunAi() {
       }
     }
   }
+}
 
-  ai_profilers_["Pikmin"].ClearTimingData();
-  for (unsigned int i = 0; i < pikmin.size(); i++) {
+void PikminGame::RunPikminAi(unsigned int first, unsigned int last) {
+  if (IsPaused()) {
+    return;
+  }
+  if (first == 0) {
+    ai_profilers_["Pikmin"].ClearTimingData();
+  }
+  for (unsigned int i = first; i < last and i < pikmin.size(); i++) {
     if (pikmin[i].active) {
       //pikmin_ai::machine.RunLogic(pikmin[i], &ai_profilers_["Pikmin"]);
       pikmin_ai::machine.RunLogic(pikmin[i]);
@@ -428,7 +463,12 @@ void PikminGame::RunAi() {
       }
     }
   }
+}
 
+void PikminGame::RunObjectAi() {
+  if (IsPaused()) {
+    return;
+  }
   for (unsigned int o = 0; o < onions.size(); o++) {
     onion_ai::machine.RunLogic(onions[o]);
     onions[o].Update();
@@ -463,39 +503,35 @@ void PikminGame::RunAi() {
       }
     }
   }
+}
 
+void PikminGame::RunCameraAi() {
+  if (IsPaused()) {
+    return;
+  }
   camera_ai::machine.RunLogic(camera_);
-
-  debug::Profiler::EndTopic(tAI);
+  current_frame_++;
 }
 
-void PikminGame::Step() {
-  current_step_++;
-  if (current_step_ % 2 == 0) {
-    // On even frames, run AI
-    scanKeys();
-    ui::machine.RunLogic(ui_);
-
-    if (IsPaused()) {
-      return;
-    }
-
-    RunAi();
-    current_frame_++;
-  } else {
-    // On odd frames, run the World, and update the engine bits
-    renderer_.Update();
+void PikminGame::UpdatePhysics() {
+  if (IsPaused()) {
+    return;
+  }
+  debug::Profiler::StartTopic(tPhysicsUpdate);
+  world_.Update();
+  debug::Profiler::EndTopic(tPhysicsUpdate);
 
-    if (!IsPaused()) {
-      debug::Profiler::StartTopic(tPhysicsUpdate);
-      world_.Update();
-      debug::Profiler::EndTopic(tPhysicsUpdate);
+  // Update some debug details about the world
+  DebugDictionary().Set("Physics: Bodies Overlapping: ", world().BodiesOverlapping());
+  DebugDictionary().Set("Physics: Total Collisions: ", world().TotalCollisions());
+  DebugDictionary().Set("Physics: Sleeping Bodies: ", world().SleepingBodies());
+  DebugDictionary().Set("Physics: Dropped Contacts: ", world().DroppedContacts());
+}
 
-      // Update some debug details about the world
-      DebugDictionary().Set("Physics: Bodies Overlapping: ", world().BodiesOverlapping());
-      DebugDictionary().Set("Physics: Total Collisions: ", world().TotalCollisions());
-    }
-  }
+void PikminGame::Step() {
+  // Alternates between AI and physics. Some of this step may already have
+  // been run while the renderer waited on the last pass.
+  scheduler_.Step();
 
   // Update basic system level debug info:
   struct mallinfo mi = mallinfo();
@@ -19,6 +19,7 @@
 #include "physics/world.h"
 #include "drawable.h"
 #include "dsgx_allocator.h"
+#include "frame_scheduler.h"
 #include "handle.h"
 #include "numeric_types.h"
 #include "ui.h"
@@ -156,7 +157,14 @@ private:
   Drawable* allocate_entity();
   MultipassRenderer& renderer_;
 
-  void RunAi();
+  // The AI is run in slices, so the scheduler can start on it early.
+  void RunCaptainAi();
+  void RunPikminAi(unsigned int first, unsigned int last);
+  void RunObjectAi();
+  void RunCameraAi();
+  void UpdatePhysics();
+
+  FrameScheduler scheduler_;
 
   template <typename StateType>
   StateType* InitObject() {
@@ -182,7 +190,6 @@ private:
   std::map<std::string, debug::AiProfiler> ai_profilers_;
 
   int current_frame_{0};
-  int current_step_{0};
 };
 
 #endif  // GAME_H
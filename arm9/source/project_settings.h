@@ -9,14 +9,25 @@
 #define CLIPPING_FUDGE_FACTOR 0
 #endif
 
-// As polygon counts are estimated (can't use the hardware to directly count)
-// we need to be able to fudge on the max per pass to achieve a good balance
-// between performance (average closer to 2048 polygons every pass) and
-// sanity (not accidentally omitting polygons because we guess badly)
+// Polygon budget per pass to start out with, in the renderer's estimated
+// polygons. Once passes have been drawn, the renderer adjusts it from what the
+// hardware reports actually went into polygon and vertex RAM.
 #ifndef MAX_POLYGONS_PER_PASS
 #define MAX_POLYGONS_PER_PASS 1800
 #endif
 
+// How many polygons (out of the hardware's 2048) the adjusted budget aims to
+// fill each pass. The rest is headroom for a pass that turns out costlier than
+// the ones before it.
+#ifndef POLYGON_RAM_TARGET
+#define POLYGON_RAM_TARGET 1900
+#endif
+
+// Number of recent passes the polygon budget has to be safe for.
+#ifndef POLYGON_BUDGET_WINDOW
+#define POLYGON_BUDGET_WINDOW 16
+#endif
+
 // This is a cheap CPU limiter; don't ever try to squeeze more than this many
 // objects into a single pass. This resolves some issues with many (MANY)
 // small objects causing frames to skip because the GPU chokes on that many
@@ -25,6 +36,60 @@
 #define MAX_OBJECTS_PER_PASS 35
 #endif
 
+// How far away (in multiples of an entity's bounding radius) a mesh's first
+// LOD takes over from the full mesh; each further LOD takes over another this
+// far out. This is scaled by the renderer's LOD quality, which drops when a
+// frame needs more than LOD_TARGET_PASSES passes' worth of polygons and
+// climbs back when it needs fewer.
+#ifndef LOD_DISTANCE
+#define LOD_DISTANCE 8
+#endif
+
+#ifndef LOD_TARGET_PASSES
+#define LOD_TARGET_PASSES 2
+#endif
+
+// Actors whose animations are baked (see main.cpp) get a whole display list for
+// every this many frames, rather than patching vertices into one on each draw.
+// Higher steps take less memory, but animate less smoothly. Baking only gets
+// the space left in the actor pool once every actor has loaded; if that isn't
+// enough, the step is doubled until it fits, up to MAX_BAKED_ANIMATION_STEP,
+// past which the actor goes on patching instead.
+#ifndef BAKED_ANIMATION_STEP
+#define BAKED_ANIMATION_STEP 4
+#endif
+
+#ifndef MAX_BAKED_ANIMATION_STEP
+#define MAX_BAKED_ANIMATION_STEP 16
+#endif
+
+// How far away (in bounding radii, scaled by LOD quality like LOD_DISTANCE) a
+// mesh with an impostor atlas is drawn as a single quad instead.
+#ifndef IMPOSTOR_DISTANCE
+#define IMPOSTOR_DISTANCE 24
+#endif
+
+// Layout of the impostor atlases: one column of IMPOSTOR_CELL_SIZE square
+// cells for each view angle, one row for each animation frame. The arm9
+// Makefile renders the atlases with, and passes in, its own copies of these.
+#ifndef IMPOSTOR_ANGLES
+#define IMPOSTOR_ANGLES 8
+#endif
+
+#ifndef IMPOSTOR_FRAMES
+#define IMPOSTOR_FRAMES 4
+#endif
+
+#ifndef IMPOSTOR_CELL_SIZE
+#define IMPOSTOR_CELL_SIZE 16
+#endif
+
+// The animation the atlas rows step through. The atlas has no poses from any
+// other, so an entity playing something else keeps drawing its mesh.
+#ifndef IMPOSTOR_ANIMATION
+#define IMPOSTOR_ANIMATION "Armature|Idle"
+#endif
+
 // Maximum number of entities, total. Used to initialize various structs
 // in the multipass engine, acts as a limiter for both scene objects and
 // static bits of a level.
@@ -33,11 +98,24 @@
 #endif
 
 // Maxiumum number of particles the engine can handle at once. Any particles
-// spawned above this limit silently fail.
+// spawned above this limit take the place of whichever is closest to expiring.
 #ifndef MAX_PARTICLES
 #define MAX_PARTICLES 256
 #endif
 
+// How deep (scaled by LOD quality, like LOD_DISTANCE) particles start being
+// thinned out: past it only every other particle is drawn, past twice that
+// every fourth, and past four times every eighth.
+#ifndef PARTICLE_THIN_DISTANCE
+#define PARTICLE_THIN_DISTANCE 16
+#endif
+
+// Most particles drawn in a frame, each one a polygon in whichever pass its
+// depth falls in. Past this, the farthest are left out.
+#ifndef PARTICLE_POLYGON_BUDGET
+#define PARTICLE_POLYGON_BUDGET 128
+#endif
+
 // Field of view, used by all 3D perspective transformations. (Ignored by ortho
 // projections)
 #ifndef FIELD_OF_VIEW
@@ -49,11 +127,49 @@
 #define MAX_PHYSICS_BODIES 256
 #endif
 
-// Number of physics neighbors to consider. Increasing this gives more accuracy
-// when many objects are near each other, but decreases performance heavily.
-// Shoot for something low but reasonable here.
-#ifndef MAX_PHYSICS_NEIGHBORS
-#define MAX_PHYSICS_NEIGHBORS 6
+// Maximum number of physics area triggers (cheap sensor volumes that aren't
+// full bodies) that can exist at once.
+#ifndef MAX_AREA_TRIGGERS
+#define MAX_AREA_TRIGGERS 64
+#endif
+
+// Size of a broadphase grid cell, as a power of two multiple of the heightmap's
+// 1-unit tiles. Bodies are bucketed into every cell they touch, so this should
+// stay a bit larger than a typical body; large sensors just cover more cells.
+#ifndef PHYSICS_GRID_CELL_SHIFT
+#define PHYSICS_GRID_CELL_SHIFT 2
+#endif
+
+// Size of a cell in the grid pikmin are separated with, in the same units as
+// PHYSICS_GRID_CELL_SHIFT. Pikmin only check their own and adjacent cells, so
+// this must be at least a pikmin's diameter.
+#ifndef PHYSICS_PIKMIN_CELL_SHIFT
+#define PHYSICS_PIKMIN_CELL_SHIFT 1
+#endif
+
+// Number of hash buckets in the broadphase grid. Must be a power of two.
+#ifndef PHYSICS_GRID_BUCKETS
+#define PHYSICS_GRID_BUCKETS 256
+#endif
+
+// Maximum number of (body, cell) pairs the broadphase grid can hold. Bodies
+// that don't fit are still collided, just by brute force, so running out costs
+// performance rather than accuracy.
+#ifndef MAX_PHYSICS_GRID_ENTRIES
+#define MAX_PHYSICS_GRID_ENTRIES 1024
+#endif
+
+// Number of physics ticks a body must sit still before it falls asleep.
+// Sleeping bodies still collide, but skip movement and level collision until
+// something disturbs them.
+#ifndef PHYSICS_SLEEP_TICKS
+#define PHYSICS_SLEEP_TICKS 30
+#endif
+
+// Maximum number of sensor contacts (including ones that ended this tick) the
+// physics world reports per tick. Anything past this is counted and dropped.
+#ifndef MAX_PHYSICS_CONTACTS
+#define MAX_PHYSICS_CONTACTS 512
 #endif
 
 // How fast objects accelerate towards the ground, per frame
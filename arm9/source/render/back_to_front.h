@@ -1,16 +1,23 @@
 #ifndef RENDER_BACK_TO_FRONT_H
 #define RENDER_BACK_TO_FRONT_H
 
+#include "render/pass_planner.h"
 #include "render/strategy.h"
 
 namespace render {
 
+// Splits the frame by depth: each pass draws a slab of the scene, back to
+// front, and is composited over the last with the rear plane. Large objects
+// that cross a slab boundary get drawn again in the next pass.
 class BackToFront : public Strategy {
   public:
+    BackToFront();
     void InitializeRender(MultipassRenderer& renderer);
-    void DrawPartition(MultipassRenderer& renderer, int partition, bool last_partition);
+    bool DrawPartition(MultipassRenderer& renderer, int partition);
+    bool FrameComplete(MultipassRenderer& renderer);
+    void EndFrame(MultipassRenderer& renderer);
   private:
-    void GatherDrawList(MultipassRenderer& renderer);
+    PassPlanner planner_;
 };
 
 } // namespace render
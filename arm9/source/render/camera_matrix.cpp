@@ -0,0 +1,93 @@
+#include "render/camera_matrix.h"
+
+#include "trig.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+using numeric_types::Brads;
+
+namespace render {
+
+namespace {
+
+fixed Dot(const Vec3& a, const Vec3& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+}  // namespace
+
+m4x4 LookAtMatrix(const Frustum& frustum) {
+  const Vec3& side = frustum.side();
+  const Vec3& up = frustum.up();
+  const Vec3& forward = frustum.forward();
+  const Vec3& eye = frustum.position();
+
+  // The camera looks down -Z, so forward goes in negated.
+  m4x4 view;
+  view.m[0]  = side.x.data_;
+  view.m[1]  = up.x.data_;
+  view.m[2]  = (0_f - forward.x).data_;
+  view.m[3]  = 0;
+
+  view.m[4]  = side.y.data_;
+  view.m[5]  = up.y.data_;
+  view.m[6]  = (0_f - forward.y).data_;
+  view.m[7]  = 0;
+
+  view.m[8]  = side.z.data_;
+  view.m[9]  = up.z.data_;
+  view.m[10] = (0_f - forward.z).data_;
+  view.m[11] = 0;
+
+  view.m[12] = (0_f - Dot(eye, side)).data_;
+  view.m[13] = (0_f - Dot(eye, up)).data_;
+  view.m[14] = Dot(eye, forward).data_;
+  view.m[15] = (1_f).data_;
+  return view;
+}
+
+m4x4 PerspectiveMatrix(fixed near, fixed far, Brads fov,
+    const ScreenWindow& window) {
+  const fixed sine = trig::SinLerp(fov);
+  const fixed cosine = trig::CosLerp(fov);
+
+  const fixed scale_x = 2_f / (window.right - window.left);
+  const fixed scale_y = 2_f / (window.top - window.bottom);
+  const fixed center_x = (window.right + window.left) / 2_f;
+  const fixed center_y = (window.top + window.bottom) / 2_f;
+
+  m4x4 projection;
+  projection.m[0]  = (((3_f * cosine) / (4_f * sine)) * scale_x).data_;
+  projection.m[1]  = 0;
+  projection.m[2]  = 0;
+  projection.m[3]  = 0;
+
+  projection.m[4]  = 0;
+  projection.m[5]  = ((cosine / sine) * scale_y).data_;
+  projection.m[6]  = 0;
+  projection.m[7]  = 0;
+
+  projection.m[8]  = (center_x * scale_x).data_;
+  projection.m[9]  = (center_y * scale_y).data_;
+  projection.m[11] = (-1.0_f).data_;
+
+  projection.m[12] = 0;
+  projection.m[13] = 0;
+  projection.m[15] = 0;
+
+  SetDepthRange(projection, near, far);
+  return projection;
+}
+
+void SetDepthRange(m4x4& projection, fixed near, fixed far) {
+  projection.m[10] = -((far + near) / (far - near)).data_;
+  projection.m[14] = -((2_f * (far * near)) / (far - near)).data_;
+}
+
+void LoadMatrix(const m4x4& matrix) {
+  for (int i = 0; i < 16; i++) {
+    MATRIX_LOAD4x4 = matrix.m[i];
+  }
+}
+
+}  // namespace render
@@ -0,0 +1,41 @@
+#ifndef RENDER_CAMERA_MATRIX_H
+#define RENDER_CAMERA_MATRIX_H
+
+#include <nds.h>
+
+#include "numeric_types.h"
+#include "render/frustum.h"
+
+namespace render {
+
+// The renderer's view and projection matrices, worked out in fixed point so
+// they can be built once per frame and loaded as they are on every pass,
+// instead of going through floats (and the ARM9's lack of an FPU) each time.
+// Matrices are laid out the way MATRIX_LOAD4x4 takes them: a row for each of
+// the X, Y, Z and W axes, 20.12 fixed point throughout.
+
+// The view gluLookAt would build for the frustum's camera, from its basis.
+m4x4 LookAtMatrix(const Frustum& frustum);
+
+// A projection matrix that, critically, does not scale Z-values. This ensures
+// that no matter how the near and far plane are set, the resulting
+// z-coordinate is not stretched or squashed, and is more or less accurate.
+// (within rounding errors.) This is necessary for the clip planes to work
+// consistently between passes, at the cost of being slightly less accurate
+// when calculating depth values. (This is hardly noticable.)
+//
+// fov is the vertical half-angle. To draw only part of the screen, the window
+// is stretched out to fill the whole clip volume, so that everything outside
+// it gets clipped.
+m4x4 PerspectiveMatrix(numeric_types::fixed near, numeric_types::fixed far,
+    numeric_types::Brads fov, const ScreenWindow& window = ScreenWindow{});
+// Moves a PerspectiveMatrix's near and far planes, leaving the rest as is.
+void SetDepthRange(m4x4& projection, numeric_types::fixed near,
+    numeric_types::fixed far);
+
+// Replaces the current matrix (of whichever mode is selected) with this one.
+void LoadMatrix(const m4x4& matrix);
+
+}  // namespace render
+
+#endif  // RENDER_CAMERA_MATRIX_H
@@ -0,0 +1,95 @@
+#include "render/frustum.h"
+
+#include "trig.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+using numeric_types::Brads;
+
+namespace render {
+
+namespace {
+
+fixed Dot(const Vec3& a, const Vec3& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Vec3 Cross(const Vec3& a, const Vec3& b) {
+  return Vec3{
+    a.y * b.z - a.z * b.y,
+    a.z * b.x - a.x * b.z,
+    a.x * b.y - a.y * b.x};
+}
+
+}  // namespace
+
+void Frustum::Set(const Vec3& position, const Vec3& subject, Brads fov,
+    fixed near, fixed far, const ScreenWindow& window) {
+  position_ = position;
+  // side is forward crossed with world up. It's taken from the unnormalized
+  // direction, which keeps its precision when looking almost straight down.
+  Vec3 direction = subject - position;
+  forward_ = direction.Normalize();
+  side_ = Vec3{-direction.z, 0_f, direction.x}.Normalize();
+  up_ = Cross(side_, forward_);
+  near_ = near;
+  far_ = far;
+
+  // The projection scales y by cos/sin and x by 3/4 of that, so the edge of
+  // the screen at y = 1 leans out at the fov angle, and the one at x = 1 at a
+  // wider angle whose tangent is 4/3 as large. Edges of a smaller window lean
+  // out in proportion.
+  const fixed sine = trig::SinLerp(fov);
+  const fixed cosine = trig::CosLerp(fov);
+  top_ = MakePlane(cosine, 0_f - window.top * sine);
+  bottom_ = MakePlane(0_f - cosine, window.bottom * sine);
+  right_ = MakePlane(3_f * cosine, 0_f - 4_f * window.right * sine);
+  left_ = MakePlane(-3_f * cosine, 4_f * window.left * sine);
+}
+
+Frustum::Plane Frustum::MakePlane(fixed lateral, fixed forward) {
+  const Vec2 normal = Vec2{lateral, forward}.Normalize();
+  return Plane{normal.x, normal.y};
+}
+
+bool Frustum::Outside(const Plane& plane, fixed sideways, fixed depth,
+    fixed radius) {
+  return sideways * plane.lateral + depth * plane.forward > radius;
+}
+
+bool Frustum::TestSphere(const Vec3& center, fixed radius, fixed& depth) const {
+  const Vec3 offset = center - position_;
+  depth = Dot(offset, forward_);
+  if (depth + radius < near_ or depth - radius > far_) {
+    return false;
+  }
+  const fixed vertical = Dot(offset, up_);
+  if (Outside(top_, vertical, depth, radius) or
+      Outside(bottom_, vertical, depth, radius)) {
+    return false;
+  }
+  const fixed horizontal = Dot(offset, side_);
+  if (Outside(right_, horizontal, depth, radius) or
+      Outside(left_, horizontal, depth, radius)) {
+    return false;
+  }
+  return true;
+}
+
+const Vec3& Frustum::position() const {
+  return position_;
+}
+
+const Vec3& Frustum::side() const {
+  return side_;
+}
+
+const Vec3& Frustum::up() const {
+  return up_;
+}
+
+const Vec3& Frustum::forward() const {
+  return forward_;
+}
+
+}  // namespace render
@@ -0,0 +1,69 @@
+#ifndef RENDER_FRUSTUM_H
+#define RENDER_FRUSTUM_H
+
+#include "numeric_types.h"
+#include "vector.h"
+
+namespace render {
+
+// A rectangle of the screen, in normalized device coordinates: -1 to 1 from
+// left to right, and from bottom to top.
+struct ScreenWindow {
+  numeric_types::fixed left = numeric_types::fixed::FromInt(-1);
+  numeric_types::fixed right = numeric_types::fixed::FromInt(1);
+  numeric_types::fixed bottom = numeric_types::fixed::FromInt(-1);
+  numeric_types::fixed top = numeric_types::fixed::FromInt(1);
+};
+
+// The camera's view volume for one frame, in world space. It's worked out once
+// per frame on the CPU, so every entity can be culled and depth sorted without
+// a BoxTest / PosTest round trip through the geometry engine.
+class Frustum {
+  public:
+    // Matches the view built by LookAtMatrix and the projection built by
+    // PerspectiveMatrix, where fov is the vertical half-angle.
+    // If window is given, the frustum only covers that part of the screen.
+    void Set(const Vec3& position, const Vec3& subject,
+        numeric_types::Brads fov, numeric_types::fixed near,
+        numeric_types::fixed far, const ScreenWindow& window = ScreenWindow{});
+
+    // Returns false if the sphere is entirely outside the frustum. Otherwise,
+    // depth is set to the distance of its center in front of the camera.
+    bool TestSphere(const Vec3& center, numeric_types::fixed radius,
+        numeric_types::fixed& depth) const;
+
+    // The camera's basis, as gluLookAt would build it.
+    const Vec3& position() const;
+    const Vec3& side() const;
+    const Vec3& up() const;
+    const Vec3& forward() const;
+
+  private:
+    // A side plane through the camera, as a unit normal in camera space split
+    // into its sideways and forward parts. A point is inside the plane when
+    // sideways * lateral + depth * forward <= 0.
+    struct Plane {
+      numeric_types::fixed lateral;
+      numeric_types::fixed forward;
+    };
+    static Plane MakePlane(numeric_types::fixed lateral, numeric_types::fixed forward);
+    static bool Outside(const Plane& plane, numeric_types::fixed sideways,
+        numeric_types::fixed depth, numeric_types::fixed radius);
+
+    Vec3 position_;
+    Vec3 side_;
+    Vec3 up_;
+    Vec3 forward_;
+
+    numeric_types::fixed near_;
+    numeric_types::fixed far_;
+
+    Plane left_;
+    Plane right_;
+    Plane bottom_;
+    Plane top_;
+};
+
+}  // namespace render
+
+#endif  // RENDER_FRUSTUM_H
@@ -0,0 +1,85 @@
+#include "render/impostors.h"
+
+#include <nds.h>
+
+#include "drawable.h"
+#include "dsgx.h"
+#include "particle.h"
+#include "project_settings.h"
+
+using numeric_types::Brads;
+using numeric_types::fixed;
+
+namespace render {
+
+namespace {
+
+// Half a column's worth of angle, so each column covers the directions either
+// side of the one it was rendered from.
+constexpr int kHalfColumn = DEGREES_IN_CIRCLE / IMPOSTOR_ANGLES / 2;
+
+}  // namespace
+
+void Impostors::SetCamera(Vec3 camera_position, Vec3 camera_subject) {
+  // Impostors stand upright, so only the turn about Y is wanted.
+  Brads x_angle;
+  CameraFacingAngles(camera_position, camera_subject, x_angle, facing_);
+}
+
+void Impostors::Draw(Drawable& entity, const Mesh& impostor) {
+  const ImpostorAtlas& atlas = *impostor.atlas;
+  const DrawState& state = entity.GetCachedState();
+
+  // The quad turns to face the camera; the further the entity is turned from
+  // that, the further around it the camera sees.
+  const int view = (facing_ - state.rotation.y).data_ + kHalfColumn;
+  const int column =
+      (view & (DEGREES_IN_CIRCLE - 1)) * IMPOSTOR_ANGLES / DEGREES_IN_CIRCLE;
+  int row = 0;
+  if (state.animation != nullptr and state.animation->frame_length > 0) {
+    row = state.animation_frame * IMPOSTOR_FRAMES /
+        state.animation->frame_length;
+  }
+
+  Vec3 center;
+  fixed radius;
+  entity.BoundingSphere(center, radius);
+
+  glPolyFmt(POLY_ALPHA(31) | POLY_ID(entity.draw_order & 0x1F) | POLY_CULL_BACK);
+  glBegin(GL_QUAD);
+  // TEXIMAGE_PARAM
+  *((u32*)0x40004A8) =
+    ((((u32)atlas.texture.offset) / 8) & 0xFFFF) |
+    (atlas.texture.format_width << 20) |
+    (atlas.texture.format_height << 23) |
+    (atlas.texture.format << 26) |
+    (atlas.texture.transparency << 29);
+  // PLTT_BASE; impostors are always a3i5, which uses 16 byte offsets.
+  *((u32*)0x40004AC) = ((u32)atlas.palette.offset - (u32)VRAM_G) / 16;
+
+  glTranslatef32(center.x.data_, center.y.data_, center.z.data_);
+  glRotateYi(facing_.data_);
+  glScalef32(radius.data_, radius.data_, radius.data_);
+
+  const int left = (column * IMPOSTOR_CELL_SIZE) << 4;
+  const int right = ((column + 1) * IMPOSTOR_CELL_SIZE) << 4;
+  const int top = (row * IMPOSTOR_CELL_SIZE) << 4;
+  const int bottom = ((row + 1) * IMPOSTOR_CELL_SIZE) << 4;
+
+  glColor(RGB15(31, 31, 31));
+  glTexCoord2t16(left, top);
+  glVertex3v16(-1 << 12,  1 << 12, 0);
+  glTexCoord2t16(right, top);
+  glVertex3v16( 1 << 12,  1 << 12, 0);
+  glTexCoord2t16(right, bottom);
+  glVertex3v16( 1 << 12, -1 << 12, 0);
+  glTexCoord2t16(left, bottom);
+  glVertex3v16(-1 << 12, -1 << 12, 0);
+  glEnd();
+
+  // Leave things as the display lists expect to find them.
+  glPolyFmt(POLY_ALPHA(31) | POLY_CULL_BACK);
+  GFX_TEX_FORMAT = 0;
+}
+
+}  // namespace render
@@ -0,0 +1,39 @@
+#ifndef RENDER_IMPOSTORS_H
+#define RENDER_IMPOSTORS_H
+
+#include "numeric_types.h"
+#include "vector.h"
+
+class Drawable;
+struct Mesh;
+
+namespace render {
+
+// Draws far away entities as a single upright quad, turned to face the camera
+// and textured with a pre-rendered view of the entity's mesh, instead of
+// sending and animating the whole mesh.
+//
+// Each atlas (see tools/blender2impostor.py) has IMPOSTOR_ANGLES columns,
+// viewing the mesh from evenly spaced directions around it, starting from
+// straight in front and turning the same way as a positive Y rotation. It has
+// IMPOSTOR_FRAMES rows, evenly spaced through the mesh's IMPOSTOR_ANIMATION,
+// first frame at the top; only entities playing that animation are drawn this
+// way (see Drawable::SelectLod). A cell frames the mesh's bounding sphere.
+//
+// Quads are drawn through the registers directly, the same way DrawParticles
+// draws particles, since the OpenGL wrappers cost more than the quad does.
+class Impostors {
+ public:
+  // Once a frame, with the camera that frame is drawn from.
+  void SetCamera(Vec3 camera_position, Vec3 camera_subject);
+  // Draws the entity as its (drawn) impostor mesh.
+  void Draw(Drawable& entity, const Mesh& impostor);
+
+ private:
+  // The Y rotation that faces a quad toward the camera.
+  numeric_types::Brads facing_;
+};
+
+}  // namespace render
+
+#endif  // RENDER_IMPOSTORS_H
@@ -1,6 +1,7 @@
 #include "render/multipass_renderer.h"
 
 #include <stdio.h>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "debug/messages.h"
 #include "debug/utilities.h"
 #include "drawable.h"
+#include "frame_scheduler.h"
 #include "project_settings.h"
 #include "particle.h"
 
@@ -25,21 +27,88 @@ using numeric_types::Brads;
 
 using debug::Topic;
 
+namespace {
+
+// Maps far_z to an unsigned key that sorts ascending in back to front order:
+// flipping the sign bit orders signed depths as unsigned, and inverting the
+// whole thing turns farthest-first into smallest-first.
+u32 DepthKey(const EntityContainer& container) {
+  return ~((u32)container.far_z.data_ ^ 0x80000000u);
+}
+
+// LSD radix sort, one byte of the depth key per pass. It's stable, so each
+// pass keeps the order set by the bytes before it. Sorts list in place, using
+// scratch as the other buffer.
+void RadixSort(EntityContainer* list, EntityContainer* scratch, unsigned int length) {
+  if (length == 0) {
+    return;
+  }
+  EntityContainer* source = list;
+  EntityContainer* destination = scratch;
+  for (int shift = 0; shift < 32; shift += 8) {
+    unsigned int counts[256] = {0};
+    for (unsigned int i = 0; i < length; i++) {
+      counts[(DepthKey(source[i]) >> shift) & 0xFF]++;
+    }
+    // Depths in view rarely differ in their upper bytes; if every entry
+    // shares this byte, the pass wouldn't change anything.
+    if (counts[(DepthKey(source[0]) >> shift) & 0xFF] == length) {
+      continue;
+    }
+    unsigned int offset = 0;
+    for (int digit = 0; digit < 256; digit++) {
+      unsigned int count = counts[digit];
+      counts[digit] = offset;
+      offset += count;
+    }
+    for (unsigned int i = 0; i < length; i++) {
+      destination[counts[(DepthKey(source[i]) >> shift) & 0xFF]++] = source[i];
+    }
+    std::swap(source, destination);
+  }
+  if (source != list) {
+    std::copy(source, source + length, list);
+  }
+}
+
+// Insertion sort that gives up once it has shifted more than budget entries,
+// leaving list in some order. Costs next to nothing on an almost sorted list.
+bool InsertionSort(EntityContainer* list, unsigned int length, int& budget) {
+  for (unsigned int i = 1; i < length; i++) {
+    EntityContainer entry = list[i];
+    const u32 key = DepthKey(entry);
+    unsigned int j = i;
+    while (j > 0 and DepthKey(list[j - 1]) > key) {
+      list[j] = list[j - 1];
+      j--;
+      if (--budget < 0) {
+        list[j] = entry;
+        return false;
+      }
+    }
+    list[j] = entry;
+  }
+  return true;
+}
+
+}  // namespace
+
 MultipassRenderer::MultipassRenderer() {
   // Initialize debug topics
   tIdle =           debug::Profiler::RegisterTopic("Engine: Idle");
+  tEarlyWork =      debug::Profiler::RegisterTopic("Engine: Early Steps");
   tEntityUpdate =   debug::Profiler::RegisterTopic("Engine: Entities");
   tParticleUpdate = debug::Profiler::RegisterTopic("Engine: Particle Updatess");
   tParticleDraw =   debug::Profiler::RegisterTopic("Engine: Particle Drawing");
   tFrameInit =      debug::Profiler::RegisterTopic("Engine: Frame Init");
   tPassInit =       debug::Profiler::RegisterTopic("Engine: Pass Init");
-  for (int i = 0; i < 5; i++) {
-    tPassUpdate[i] = debug::Profiler::RegisterTopic("Engine: Pass: " + std::to_string(i + 1));
-  }
+  clear_plane_projection_ = render::PerspectiveMatrix(0.1_f, 768.0_f,
+      1000.0_brad);
   SetCamera(Vec3{0_f, 10_f, 0_f}, Vec3{64_f, 0_f, -62_f}, 45_brad);
   CacheCamera();
 
-  current_strategy_ = new render::BackToFront();
+  current_strategy_ = &back_to_front_;
+  lod_quality_ = 1_f;
 }
 
 void MultipassRenderer::EnableEffectsLayer(bool enabled) {
@@ -66,13 +135,12 @@ bool MultipassRenderer::IsPaused() {
   return paused_;
 }
 
+void MultipassRenderer::SetScheduler(FrameScheduler* scheduler) {
+  scheduler_ = scheduler;
+}
+
 void MultipassRenderer::WaitForVBlank() {
-  //debug::Log("REG_VCOUNT before: " + std::to_string(REG_VCOUNT));
-  //swiWaitForVBlank();
-  //debug::Log("REG_VCOUNT after: " + std::to_string(REG_VCOUNT));
-  while (REG_VCOUNT != 192) {
-    continue;
-  }
+  FrameScheduler::WaitForVBlank();
 }
 
 void MultipassRenderer::AddEntity(Drawable* entity) {
@@ -99,39 +167,9 @@ void MultipassRenderer::Update() {
   debug::Profiler::EndTopic(tParticleUpdate);
 }
 
-void MultipassRenderer::ClipFriendlyPerspective(fixed near, fixed far, Brads angle) {
-  // Setup a projection matrix that, critically, does not scale Z-values. This
-  // ensures that no matter how the near and far plane are set, the resulting
-  // z-coordinate is not stretched or squashed, and is more or less accurate.
-  // (within rounding errors.) This is necessary for the clip planes to work
-  // consistently between passes, at the cost of being slightly less accurate
-  // when calculating depth values. (This is hardly noticable.)
+void MultipassRenderer::LoadProjection(const m4x4& projection) {
   glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-
-  fixed sine = trig::SinLerp(angle);
-  fixed cosine = trig::CosLerp(angle);
-  //fixed cosine = trig::SinLerp(angle);
-
-  MATRIX_LOAD4x4  = (((3_f * cosine) / (4_f * sine)).data_);
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = 0;
-
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = (cosine / sine).data_;
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = 0;
-
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = -((far + near) / (far - near)).data_;
-  MATRIX_LOAD4x4  = (-1.0_f).data_;
-
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = 0;
-  MATRIX_LOAD4x4  = -((2_f * (far * near)) / (far - near)).data_;
-  MATRIX_LOAD4x4  = 0;
+  render::LoadMatrix(projection);
   glMatrixMode(GL_MODELVIEW);
 }
 
@@ -139,27 +177,106 @@ void MultipassRenderer::CacheCamera() {
   cached_camera_position_ = current_camera_position_;
   cached_camera_subject_ = current_camera_subject_;
   cached_camera_fov_ = current_camera_fov_;
+  cached_frustum_.Set(cached_camera_position_, cached_camera_subject_,
+      cached_camera_fov_, 0.1_f, 256.0_f);
+  view_matrix_ = render::LookAtMatrix(cached_frustum_);
+  projection_ = render::PerspectiveMatrix(0.1_f, 256.0_f, cached_camera_fov_);
+  impostors_.SetCamera(cached_camera_position_, cached_camera_subject_);
 }
 
 void MultipassRenderer::ApplyCameraTransform() {
-  gluLookAt(
-      (float)cached_camera_position_.x, (float)cached_camera_position_.y,
-      (float)cached_camera_position_.z, (float)cached_camera_subject_.x,
-      (float)cached_camera_subject_.y,  (float)cached_camera_subject_.z,
-      0.0f, 1.0f, 0.0f);
+  render::LoadMatrix(view_matrix_);
+}
+
+bool MultipassRenderer::AddToDrawList(const EntityContainer& container) {
+  if (draw_list_count_ >= MAX_ENTITIES) {
+    return false;
+  }
+  draw_list_count_++;
+
+  // Anything drawn last frame goes back into the slot it was sorted into, so
+  // the list starts out in last frame's order. Everything else is new, and
+  // collects at the front of the draw list.
+  Drawable* entity = container.entity;
+  if (entity->draw_order < previous_count_ and
+      previous_order_[entity->draw_order] == entity) {
+    sort_scratch_[entity->draw_order] = container;
+  } else {
+    draw_list_[new_count_++] = container;
+  }
+  return true;
+}
+
+void MultipassRenderer::SortDrawList() {
+  // Pack last frame's survivors in behind the newcomers, keeping their order.
+  unsigned int count = new_count_;
+  for (unsigned int i = 0; i < previous_count_; i++) {
+    if (sort_scratch_[i].entity != nullptr) {
+      draw_list_[count++] = sort_scratch_[i];
+    }
+  }
+
+  if (camera_cut_ or not RepairDrawList()) {
+    RadixSort(draw_list_, sort_scratch_, draw_list_count_);
+  }
+  camera_cut_ = false;
+
+  // Remember this order for next frame.
+  for (unsigned int i = 0; i < draw_list_count_; i++) {
+    previous_order_[i] = draw_list_[i].entity;
+    draw_list_[i].entity->draw_order = i;
+  }
+  previous_count_ = draw_list_count_;
+}
+
+bool MultipassRenderer::RepairDrawList() {
+  // When little has moved relative to the camera, last frame's order needs
+  // only a few swaps, and the newcomers are usually a handful of entities
+  // walking into view. Insertion sort both, then merge them. If that turns
+  // out to be more work than a full radix sort would have been, give up.
+  int budget = draw_list_count_ * 4;
+  EntityContainer* tail = draw_list_ + new_count_;
+  const unsigned int tail_count = draw_list_count_ - new_count_;
+  if (not InsertionSort(tail, tail_count, budget) or
+      not InsertionSort(draw_list_, new_count_, budget)) {
+    return false;
+  }
+  if (new_count_ == 0 or tail_count == 0) {
+    return true;
+  }
+  std::merge(draw_list_, tail, tail, tail + tail_count, sort_scratch_,
+      [](const EntityContainer& a, const EntityContainer& b) {
+        return DepthKey(a) < DepthKey(b);
+      });
+  std::copy(sort_scratch_, sort_scratch_ + draw_list_count_, draw_list_);
+  return true;
+}
+
+void MultipassRenderer::CameraCut() {
+  camera_cut_ = true;
 }
 
 void MultipassRenderer::ClearDrawList() {
-  // Clear the draw list so that the next frame gets triggered.
-  // It is emptied by looping because std::priority_queue does not provide
-  // a clear function.
-  while (not draw_list_.empty()) {
-    draw_list_.pop();
+  // Clear the draw list so that the next frame gets triggered, and empty the
+  // slots AddToDrawList sorts last frame's entities back into.
+  draw_list_count_ = 0;
+  draw_list_cursor_ = 0;
+  new_count_ = 0;
+  for (unsigned int i = 0; i < previous_count_; i++) {
+    sort_scratch_[i].entity = nullptr;
   }
 }
 
+bool MultipassRenderer::DrawListEmpty() {
+  return draw_list_cursor_ >= draw_list_count_;
+}
+
+unsigned int MultipassRenderer::DrawListRemaining() {
+  return draw_list_count_ - draw_list_cursor_;
+}
+
 bool MultipassRenderer::LastPass() {
-  return draw_list_.empty() and (effects_drawn or !effects_enabled);
+  return current_strategy_->FrameComplete(*this) and (effects_drawn or !effects_enabled);
 }
 
 void MultipassRenderer::SetVRAMforPass(int pass) {
@@ -198,6 +315,10 @@ void MultipassRenderer::SetVRAMforPass(int pass) {
 }
 
 void MultipassRenderer::DrawClearPlane() {
+  // Screen space strategies narrow the viewport to their part of the screen;
+  // the rear plane always covers all of it.
+  glViewport(0, 0, 255, 191);
+
   if (current_pass_ == 0)
   {
     // Don't draw the rear-plane texture on the first pass; instead, the clear
@@ -207,7 +328,7 @@ void MultipassRenderer::DrawClearPlane() {
 
   // Because the rear texture needs to cover the whole screen no matter what,
   // draw it using an orthagonal projection.
-  ClipFriendlyPerspective(0.1_f, 768.0_f, 1000.0_brad);
+  LoadProjection(clear_plane_projection_);
   glLoadIdentity();
 
   // Set the draw mode to quad, set up the texture format, and draw the back
@@ -247,11 +368,25 @@ void MultipassRenderer::DrawClearPlane() {
   GFX_TEX_FORMAT = 0;
 }
 
-void MultipassRenderer::InitializeRender() {
-  // Initialize the debug counts for this pass
-  for (int i = current_pass_; i < 5; i++) {
-    debug::Profiler::ClearTopic(tPassUpdate[i]);
+void MultipassRenderer::SelectStrategy() {
+  render::Strategy* strategy = &back_to_front_;
+  if (debug::Flag("Render Top to Bottom")) {
+    strategy = &top_to_bottom_;
+  } else if (debug::Flag("Render Side to Side")) {
+    strategy = &side_to_side_;
   }
+  if (strategy != current_strategy_) {
+    // Don't leave the old strategy's timings up as if they were current.
+    current_strategy_->ClearPassTopics(true);
+    current_strategy_ = strategy;
+  }
+  current_strategy_->ClearPassTopics();
+}
+
+void MultipassRenderer::InitializeRender() {
+  // Strategies only change between frames, since every pass of a frame has to
+  // agree on how it's split up.
+  SelectStrategy();
 
   //debug::TimingColor(RGB5(0, 15, 0));
   debug::Profiler::StartTopic(tFrameInit);
@@ -264,8 +399,16 @@ void MultipassRenderer::InitializeRender() {
   // tearing.
   CacheCamera();
 
-  // Ensure the overlap list is empty.
-  overlap_list_.clear();
+  // Particles are culled and thinned before the strategy plans its passes,
+  // since they take up room in them.
+  const fixed thin_distance = debug::Flag("Render Full Detail") ? 0_f :
+      fixed::FromInt(PARTICLE_THIN_DISTANCE) * lod_quality_;
+  prepared_particles_ = PrepareParticles(cached_frustum_,
+      cached_camera_position_, cached_camera_subject_, thin_distance);
+
+  // Start from empty draw and overlap lists.
+  ClearDrawList();
+  overlap_count_ = 0;
 
   current_pass_ = 0;
   effects_drawn = false;
@@ -276,58 +419,157 @@ void MultipassRenderer::InitializeRender() {
   debug::Profiler::EndTopic(tFrameInit);
 }
 
-void MultipassRenderer::GatherPassList() {
+void MultipassRenderer::GatherDrawList() {
+  const bool full_detail = debug::Flag("Render Full Detail");
+  int polygons = 0;
+
+  // Culling and depth both come from the full 0.1 - 256 frustum, so the list
+  // can be sorted without having to account for the per-pass clip planes.
+  for (auto entity : entities_) {
+    // Cache the object so its render information stays the same across
+    // multiple passes.
+    entity->SetCache();
+
+    Vec3 center;
+    fixed radius;
+    entity->BoundingSphere(center, radius);
+    fixed object_z;
+    if (cached_frustum_.TestSphere(center, radius, object_z)) {
+      // Using the camera state, calculate the nearest and farthest points,
+      // which we'll later use to decide where the clipping planes should go.
+      EntityContainer container;
+      container.entity = entity;
+      if (entity->important) {
+        container.far_z  = object_z + radius;
+        container.near_z = object_z - radius;
+      } else {
+        container.far_z  = object_z;
+        container.near_z = object_z;
+      }
+
+      if (not full_detail) {
+        const fixed reach = radius * lod_quality_;
+        entity->SelectLod(object_z, reach * fixed::FromInt(LOD_DISTANCE),
+            reach * fixed::FromInt(IMPOSTOR_DISTANCE));
+      }
+
+      // Past MAX_ENTITIES, anything else in view is simply not drawn.
+      entity->visible = AddToDrawList(container);
+      entity->overlaps = 0;
+      if (entity->visible and entity->DrawnMesh() != nullptr) {
+        polygons += polygon_budget_.Cost(*entity->DrawnMesh());
+      }
+    } else {
+      entity->visible = false;
+    }
+  }
+
+  SortDrawList();
+  UpdateLodQuality(polygons + prepared_particles_);
+}
+
+void MultipassRenderer::UpdateLodQuality(int polygons) {
+  // Nudge LODs in or out a little each frame, until the frame fits in
+  // LOD_TARGET_PASSES passes without any more detail being given up than
+  // that takes. When a scene is cheap, everything ends up at full detail.
+  const int target = polygon_budget_.PassBudget() * LOD_TARGET_PASSES;
+  if (polygons > target) {
+    lod_quality_ = lod_quality_ * 15_f / 16_f;
+  } else if (polygons * 4 < target * 3) {
+    lod_quality_ = lod_quality_ * 17_f / 16_f;
+  }
+  if (lod_quality_ < 0.25_f) {
+    lod_quality_ = 0.25_f;
+  }
+  if (lod_quality_ > 4_f) {
+    lod_quality_ = 4_f;
+  }
+}
+
+void MultipassRenderer::GatherPassList(unsigned int pass_end) {
   debug::Profiler::StartTopic(tPassInit);
 
   // Build up the list of objects to render this pass.
   int polycount = 0;
-  pass_list_.clear();
+  pass_count_ = 0;
 
   // If there were any objects that straddle the current and previous passes,
   // ensure that they are drawn again this pass.
-  // int overlaps_count = overlap_list_.size();
-  for (auto entity : overlap_list_) {
-    pass_list_.push_back(entity);
-    polycount += pass_list_.back().entity->GetCachedState().current_mesh->draw_cost;
+  for (unsigned int i = 0; i < overlap_count_; i++) {
+    pass_list_[pass_count_++] = overlap_list_[i];
+    polycount += polygon_budget_.Cost(*overlap_list_[i].entity->DrawnMesh());
   }
-  if (polycount >= MAX_POLYGONS_PER_PASS) {
+  if (polycount >= polygon_budget_.PassBudget()) {
     // attempt to recover here; *drop* the overlap list, and rebuild it only
     // out of "important" flagged items; this will have the effect of creating
     // artifacts for unimportant items (pikmin) but it should cause the render
     // to succeed, for some definition of success
-    pass_list_.clear();
+    pass_count_ = 0;
     polycount = 0;
-    for (auto entity : overlap_list_) {
-      if (entity.entity->important) {
-        pass_list_.push_back(entity);
-        polycount += pass_list_.back().entity->GetCachedState().current_mesh->draw_cost;
+    for (unsigned int i = 0; i < overlap_count_; i++) {
+      if (overlap_list_[i].entity->important) {
+        pass_list_[pass_count_++] = overlap_list_[i];
+        polycount += polygon_budget_.Cost(*overlap_list_[i].entity->DrawnMesh());
       }
     }
   }
-  overlap_list_.clear();
-
-  int objects_this_pass = 0;
+  overlap_count_ = 0;
 
-  // Pull entities from the list of all entities to draw this frame until all
-  // objects are marked for drawing (marking a complete frame) or the polygon
-  // quota is hit, whichever comes first.
-  while (not draw_list_.empty() and polycount < MAX_POLYGONS_PER_PASS and objects_this_pass < MAX_OBJECTS_PER_PASS) {
-    pass_list_.push_back(draw_list_.top());
-    polycount += pass_list_.back().entity->GetCachedState().current_mesh->draw_cost;
-    draw_list_.pop();
-    objects_this_pass++;
+  // Walk the sorted draw list up to where this pass ends.
+  while (draw_list_cursor_ < pass_end) {
+    pass_list_[pass_count_++] = draw_list_[draw_list_cursor_++];
   }
+  GroupByAnimationFrame(pass_list_, pass_count_);
 
   debug::Profiler::EndTopic(tPassInit);
 }
 
+void MultipassRenderer::GroupByAnimationFrame(EntityContainer* list,
+    unsigned int count) {
+  // Every entity drawing an animated mesh shares its display list, and has to
+  // patch its own frame into it first; entities on the same frame drawn one
+  // after another only need the first of them to. Within a pass the depth
+  // buffer sorts out opaque polygons whatever order they're sent in, so only
+  // important entities, which may be large or translucent, hold their place
+  // in the back to front order. Each run between them is grouped by mesh,
+  // animation and frame, and otherwise stays back to front.
+  auto before = [](const EntityContainer& a, const EntityContainer& b) {
+    const Mesh* a_mesh = a.entity->DrawnMesh();
+    const Mesh* b_mesh = b.entity->DrawnMesh();
+    if (a_mesh != b_mesh) {
+      return a_mesh < b_mesh;
+    }
+    const Animation* a_animation = a.entity->DrawnAnimation();
+    const Animation* b_animation = b.entity->DrawnAnimation();
+    if (a_animation != b_animation) {
+      return a_animation < b_animation;
+    }
+    if (a_animation != nullptr) {
+      const u32 a_frame = a.entity->GetCachedState().animation_frame;
+      const u32 b_frame = b.entity->GetCachedState().animation_frame;
+      if (a_frame != b_frame) {
+        return a_frame < b_frame;
+      }
+    }
+    return a.entity->draw_order < b.entity->draw_order;
+  };
+
+  unsigned int run_start = 0;
+  for (unsigned int i = 0; i <= count; i++) {
+    if (i == count or list[i].entity->important) {
+      if (i - run_start > 1) {
+        std::sort(list + run_start, list + i, before);
+      }
+      run_start = i + 1;
+    }
+  }
+}
+
 bool MultipassRenderer::ProgressMadeThisPass(unsigned int initial_length) {
-  // If nothing was moved from the draw list for the frame this pass, than means
-  //   1. There were no objects to draw at all this frame, or
-  //   2. There is an object that exceeds the maximum polygon count per pass on
-  //      its own, or there are too many objects in a perpendicular line to the
-  //      camera's viewing angle.
-  if (draw_list_.size() == initial_length) {
+  // If nothing was moved from the draw list for the frame this pass, there
+  // were no objects to draw at all this frame. (The pass planner always gives
+  // every pass at least one entity, over budget or not.)
+  if (DrawListRemaining() == initial_length) {
     return false;
   }
   return true;
@@ -353,8 +595,8 @@ void MultipassRenderer::SetupDividingPlane() {
     far_plane_ = near_plane_;
   }
   near_plane_ = 0.1_f;
-  if (not draw_list_.empty()) {
-    near_plane_ = draw_list_.top().far_z;
+  if (not DrawListEmpty()) {
+    near_plane_ = draw_list_[draw_list_cursor_].far_z;
     // If that entity is too close to or behind the camera, then clamp the near
     // plane to just in front of the camera.
     if (near_plane_ < 0.1_f) {
@@ -364,9 +606,10 @@ void MultipassRenderer::SetupDividingPlane() {
 
   // Set up the matrices for the render based on the near and far plane
   // calculations.
-  //ClipFriendlyPerspective(near_plane_, far_plane_, cached_camera_fov_);
-  ClipFriendlyPerspective(0.1_f, far_plane_, cached_camera_fov_);
-  glLoadIdentity();
+  m4x4 projection = projection_;
+  //render::SetDepthRange(projection, near_plane_, far_plane_);
+  render::SetDepthRange(projection, 0.1_f, far_plane_);
+  LoadProjection(projection);
   ApplyCameraTransform();
 }
 
@@ -405,30 +648,75 @@ bool MultipassRenderer::ValidateDividingPlane() {
 
 void MultipassRenderer::DrawPassList() {
   // Draw the entities for the pass.
-  if (current_pass_ < 9) {
-    debug::Profiler::StartTopic(tPassUpdate[current_pass_]);
-  }
-
-  for (auto& container : pass_list_) {
-    glPushMatrix();
-    container.entity->Draw();
-    glPopMatrix(1);
+  for (unsigned int i = 0; i < pass_count_; i++) {
+    EntityContainer& container = pass_list_[i];
+    // Anything cut by a dividing plane, now or last pass, only partly draws.
+    const bool cut = container.near_z < near_plane_ or container.entity->overlaps > 0;
+    DrawEntity(container.entity, not cut);
 
     // If this object is not fully drawn, add it to the overlap list to be
     // redrawn in the next pass.
     if (container.near_z < near_plane_ /*and near_plane_ > floattof32(0.1)*/) {
       container.entity->overlaps++;
-      overlap_list_.push_back(container);
+      overlap_list_[overlap_count_++] = container;
     }
   }
-  if (current_pass_ < 9) {
-    debug::Profiler::EndTopic(tPassUpdate[current_pass_]);
+}
+
+void MultipassRenderer::DrawEntity(Drawable* entity, bool measurable) {
+  Mesh* mesh = entity->DrawnMesh();
+  // Measuring an entity on its own means letting the geometry engine catch up
+  // before and after it, so the budget only asks for one now and then.
+  const bool sample = measurable and mesh != nullptr and
+      polygon_budget_.WantsSample(*mesh);
+  int polygons_before = 0;
+  if (sample) {
+    WaitForGeometry();
+    polygons_before = GFX_POLYGON_RAM_USAGE;
+  }
+
+  glPushMatrix();
+  if (mesh != nullptr and mesh->atlas != nullptr) {
+    impostors_.Draw(*entity, *mesh);
+  } else {
+    entity->Draw();
+  }
+  glPopMatrix(1);
+
+  if (mesh != nullptr) {
+    polygon_budget_.Drawn(*mesh);
+  }
+  if (sample) {
+    WaitForGeometry();
+    const int polygons_after = GFX_POLYGON_RAM_USAGE;
+    // A full polygon RAM can't say how much more the entity wanted.
+    if (polygons_after < render::PolygonBudget::kPolygonCapacity) {
+      polygon_budget_.Sample(*mesh, polygons_after - polygons_before);
+    }
+  }
+}
+
+void MultipassRenderer::DrawPassParticles(fixed near, fixed far,
+    const render::Frustum* frustum) {
+  debug::Profiler::StartTopic(tParticleDraw);
+  polygon_budget_.Drawn(DrawParticles(near, far, frustum));
+  debug::Profiler::EndTopic(tParticleDraw);
+
+  // Reset the polygon format after all that drawing
+  glPolyFmt(POLY_ALPHA(31) | POLY_CULL_BACK);
+}
+
+void MultipassRenderer::WaitForGeometry() {
+  // The RAM usage counts only include what the geometry engine has finished
+  // with, so let it empty the FIFO first.
+  while (GFX_STATUS & BIT(27)) {
+    continue;
   }
 }
 
 void MultipassRenderer::DrawEffects() {
-  ClipFriendlyPerspective(0.1_f, 768.0_f, cached_camera_fov_);
-  glLoadIdentity();
+  glViewport(0, 0, 255, 191);
+  LoadProjection(render::PerspectiveMatrix(0.1_f, 768.0_f, cached_camera_fov_));
   ApplyCameraTransform();
   debug::DrawEffects();
   effects_drawn = true;
@@ -439,43 +727,43 @@ void MultipassRenderer::Draw() {
     InitializeRender();
   }
 
-  if (draw_list_.empty() and effects_enabled) {
+  bool measure_pass = false;
+  if (current_strategy_->FrameComplete(*this) and effects_enabled) {
     DrawEffects();
   } else {
-    unsigned int initial_length = draw_list_.size();
-    GatherPassList();
-
-    if (not ProgressMadeThisPass(initial_length)) {
-      BailAndResetFrame();
+    polygon_budget_.StartPass();
+    if (not current_strategy_->DrawPartition(*this, current_pass_)) {
       return;
     }
+    measure_pass = true;
+  }
 
-    SetupDividingPlane();
-
-    if (not ValidateDividingPlane()) {
-      return;
-    }
+  DrawClearPlane();
 
-    DrawPassList();
+  if (measure_pass) {
+    // Feed back what the pass really cost, particles and all, before the swap
+    // resets the counts.
+    WaitForGeometry();
+    polygon_budget_.EndPass(GFX_POLYGON_RAM_USAGE, GFX_VERTEX_RAM_USAGE);
+  }
 
-    debug::Profiler::StartTopic(tParticleDraw);
-    DrawParticles(cached_camera_position_, cached_camera_subject_);
-    debug::Profiler::EndTopic(tParticleDraw);
+  GFX_FLUSH = GL_WBUFFERING;
 
-    // Reset the polygon format after all that drawing
-    glPolyFmt(POLY_ALPHA(31) | POLY_CULL_BACK);
+  // The pass is in the hardware's hands now; rather than sit idle until it's
+  // captured, get started on the game's next step.
+  if (scheduler_ != nullptr) {
+    debug::Profiler::StartTopic(tEarlyWork);
+    scheduler_->RunUntilVBlank();
+    debug::Profiler::EndTopic(tEarlyWork);
   }
 
-  DrawClearPlane();
-
-  GFX_FLUSH = GL_WBUFFERING;
   debug::Profiler::StartTopic(tIdle);
 
   WaitForVBlank();
 
   if (debug::Flag("Render First Pass Only")) {
-    // Empty the draw list; limiting the frame to one pass.
-    ClearDrawList();
+    // Skip the rest of the frame; limiting it to one pass.
+    current_strategy_->EndFrame(*this);
   }
 
   SetVRAMforPass(current_pass_);
@@ -2,24 +2,28 @@
 #define MULTIPASS_RENDERER_H
 
 #include <list>
-#include <queue>
 
 #include "debug/profiler.h"
 #include "render/strategy.h"
 #include "render/back_to_front.h"
+#include "render/camera_matrix.h"
+#include "render/frustum.h"
+#include "render/impostors.h"
+#include "render/polygon_budget.h"
+#include "render/side_to_side.h"
+#include "render/top_to_bottom.h"
 #include "numeric_types.h"
+#include "project_settings.h"
 #include "vector.h"
 
 class Drawable;
+class FrameScheduler;
 
 struct EntityContainer {
 
   Drawable* entity;
   numeric_types::fixed near_z;
   numeric_types::fixed far_z;
-  bool operator<(const EntityContainer& other) const {
-    return far_z < other.far_z;
-  }
 };
 
 class MultipassRenderer {
@@ -37,6 +41,13 @@ class MultipassRenderer {
   bool IsPaused();
 
   void SetCamera(Vec3 position, Vec3 subject, numeric_types::Brads fov);
+  // Tells the renderer the view is about to change too much for last frame's
+  // draw order to be a useful starting point, so the next frame sorts from
+  // scratch.
+  void CameraCut();
+
+  // Work to get on with while waiting for each pass to finish, if any.
+  void SetScheduler(FrameScheduler* scheduler);
 
   void EnableEffectsLayer(bool enabled);
   void DebugCircles();
@@ -44,39 +55,84 @@ class MultipassRenderer {
  private:
   friend class render::Strategy;
   friend class render::BackToFront;
+  friend class render::ScreenPartition;
+  void SelectStrategy();
   void InitializeRender();
 
+  void GatherDrawList();
+  void UpdateLodQuality(int polygons);
+
+  bool AddToDrawList(const EntityContainer& container);
+  void SortDrawList();
+  bool RepairDrawList();
   void ClearDrawList();
+  bool DrawListEmpty();
+  unsigned int DrawListRemaining();
   void SetVRAMforPass(int pass);
   void DrawClearPlane();
   void BailAndResetFrame();
 
   void CacheCamera();
+  // Replaces the modelview matrix with the frame's view.
   void ApplyCameraTransform();
 
-  void GatherPassList();
+  void GatherPassList(unsigned int pass_end);
+  void GroupByAnimationFrame(EntityContainer* list, unsigned int count);
   bool ProgressMadeThisPass(unsigned int initial_length);
   void SetupDividingPlane();
   bool ValidateDividingPlane();
   void DrawPassList();
+  void DrawEntity(Drawable* entity, bool measurable);
+  // Draws the frame's particles from near (inclusive) to far (exclusive), and
+  // inside frustum if given, after the pass's entities.
+  void DrawPassParticles(numeric_types::fixed near, numeric_types::fixed far,
+      const render::Frustum* frustum = nullptr);
+  void WaitForGeometry();
   bool LastPass();
   void DrawEffects();
 
   void WaitForVBlank();
 
-  void ClipFriendlyPerspective(numeric_types::fixed near, numeric_types::fixed far, numeric_types::Brads angle);
+  void LoadProjection(const m4x4& projection);
 
+  render::BackToFront back_to_front_;
+  render::TopToBottom top_to_bottom_;
+  render::SideToSide side_to_side_;
   render::Strategy* current_strategy_;
+  render::PolygonBudget polygon_budget_;
+  render::Impostors impostors_;
+  FrameScheduler* scheduler_{nullptr};
   bool paused_ = false;
 
   std::list<Drawable*> entities_;
 
-  std::priority_queue<EntityContainer> draw_list_;
-  std::vector<EntityContainer> overlap_list_;
-  std::vector<EntityContainer> pass_list_;
+  // Everything visible this frame, sorted back to front once when the frame
+  // starts. Each pass takes entries starting at draw_list_cursor_.
+  EntityContainer draw_list_[MAX_ENTITIES];
+  EntityContainer sort_scratch_[MAX_ENTITIES];
+  unsigned int draw_list_count_{0};
+  unsigned int draw_list_cursor_{0};
+  // Entities that weren't in last frame's draw list; these sit at the front of
+  // draw_list_ until it's sorted.
+  unsigned int new_count_{0};
+
+  // Last frame's sorted draw list, used as the starting point for this one.
+  // Entries may point to entities that have since been destroyed; they're only
+  // ever compared against, never followed.
+  Drawable* previous_order_[MAX_ENTITIES];
+  unsigned int previous_count_{0};
+  bool camera_cut_{true};
+
+  EntityContainer overlap_list_[MAX_ENTITIES];
+  unsigned int overlap_count_{0};
+  EntityContainer pass_list_[MAX_ENTITIES];
+  unsigned int pass_count_{0};
 
   int current_pass_{0};
 
+  // Particles this frame draws; one polygon each.
+  int prepared_particles_{0};
+
   numeric_types::fixed near_plane_;
   numeric_types::fixed far_plane_;
 
@@ -87,6 +143,17 @@ class MultipassRenderer {
   Vec3 cached_camera_position_;
   Vec3 cached_camera_subject_;
   numeric_types::Brads cached_camera_fov_;
+  render::Frustum cached_frustum_;
+  // Worked out once per frame from the cached camera; the projection covers
+  // the full 0.1 - 256 depth range, and passes move its planes as they need.
+  m4x4 view_matrix_;
+  m4x4 projection_;
+  // The rear plane is always drawn with the same projection.
+  m4x4 clear_plane_projection_;
+
+  // Scales how far out LODs and impostors take over; below 1 they take over
+  // sooner.
+  numeric_types::fixed lod_quality_;
 
   unsigned int frame_counter_{0};
 
@@ -100,7 +167,7 @@ class MultipassRenderer {
   int tFrameInit;
   int tPassInit;
   int tIdle;
-  std::vector<int> tPassUpdate;
+  int tEarlyWork;
 };
 
 #endif  // MULTIPASS_ENGINE_H
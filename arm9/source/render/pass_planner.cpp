@@ -0,0 +1,151 @@
+#include "render/pass_planner.h"
+
+#include <algorithm>
+
+#include "render/multipass_renderer.h"
+#include "render/polygon_budget.h"
+#include "drawable.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+
+namespace render {
+
+namespace {
+
+constexpr int kOverBudgetCost = 16;
+constexpr int kNoPlan = 0x7FFFFFFF;
+
+int DrawCost(const EntityContainer& container, const PolygonBudget& budget) {
+  return budget.Cost(*container.entity->DrawnMesh());
+}
+
+// How many particles are at least this deep.
+int ParticlesBehind(fixed plane, const fixed* depths, unsigned int count) {
+  return std::partition_point(depths, depths + count,
+      [plane](fixed depth) {
+        return not (depth < plane);
+      }) - depths;
+}
+
+}  // namespace
+
+fixed PassPlanner::Plane(const EntityContainer* list, unsigned int index) const {
+  // The depth of the dividing plane in front of a pass that starts (or behind
+  // one that ends) at this index, as SetupDividingPlane will place it.
+  if (index == 0) {
+    return 256_f;
+  }
+  if (index >= count_ or list[index].far_z < 0.1_f) {
+    return 0.1_f;
+  }
+  return list[index].far_z;
+}
+
+void PassPlanner::Plan(const EntityContainer* list, unsigned int count,
+    const PolygonBudget& budget, const fixed* particle_depths,
+    unsigned int particle_count) {
+  count_ = count;
+  passes_ = 0;
+  if (count == 0) {
+    return;
+  }
+
+  // Every pass costs a full pass worth of polygons, used or not.
+  const int pass_budget = budget.PassBudget();
+  // Each object over MAX_OBJECTS_PER_PASS counts as this many polygons over.
+  const int polygons_per_object = pass_budget / MAX_OBJECTS_PER_PASS;
+
+  polygons_before_[0] = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    polygons_before_[i + 1] = polygons_before_[i] + DrawCost(list[i], budget);
+  }
+  // A pass between two cut points also draws every particle between their
+  // planes.
+  for (unsigned int i = 0; i <= count; i++) {
+    polygons_before_[i] += ParticlesBehind(Plane(list, i), particle_depths,
+        particle_count);
+  }
+
+  // A pass starting at a redraws every earlier entity that reaches in front
+  // of that pass's far plane. Only important entities have any depth, so only
+  // they can overlap.
+  for (unsigned int a = 0; a <= count; a++) {
+    overlap_polygons_[a] = 0;
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    if (not list[i].entity->important) {
+      continue;
+    }
+    for (unsigned int a = i + 1; a < count; a++) {
+      if (not (list[i].near_z < Plane(list, a))) {
+        break;
+      }
+      overlap_polygons_[a] += DrawCost(list[i], budget);
+    }
+  }
+
+  // best_cost_[b] is the cheapest way to draw everything before b, with a
+  // pass ending at b.
+  best_cost_[0] = 0;
+  for (unsigned int b = 1; b <= count; b++) {
+    best_cost_[b] = kNoPlan;
+    const fixed near_plane = Plane(list, b);
+    // Cutting here would leave the next pass nothing to draw but entities on
+    // top of the camera, which ends the frame early.
+    if (b < count and near_plane == 0.1_f) {
+      continue;
+    }
+    bool found_plan = false;
+    for (int a = b - 1; a >= 0; a--) {
+      const int new_polygons = polygons_before_[b] - polygons_before_[a];
+      const int objects_over = (int)(b - a) - MAX_OBJECTS_PER_PASS;
+      // Starting the pass any earlier only adds more, so once the entities it
+      // takes from the draw list are over budget by themselves, stop looking
+      // as soon as there's something to fall back on.
+      if ((new_polygons > pass_budget or objects_over > 0) and found_plan) {
+        break;
+      }
+      int over = overlap_polygons_[a] + new_polygons - pass_budget;
+      if (objects_over > 0) {
+        over = (over > 0 ? over : 0) + objects_over * polygons_per_object;
+      }
+      // The dividing plane has to move forward, or the pass has no depth.
+      if (best_cost_[a] == kNoPlan or not (near_plane < Plane(list, a))) {
+        continue;
+      }
+      int cost = best_cost_[a] + pass_budget + overlap_polygons_[a];
+      if (over > 0) {
+        cost += over * kOverBudgetCost;
+      }
+      if (cost < best_cost_[b]) {
+        best_cost_[b] = cost;
+        best_start_[b] = a;
+      }
+      found_plan = true;
+    }
+  }
+
+  // Walk the plan back from the end of the list. A plan always exists, since
+  // a single pass over everything is always allowed.
+  for (unsigned int b = count; b > 0; b = best_start_[b]) {
+    passes_++;
+  }
+  unsigned int pass = passes_;
+  for (unsigned int b = count; b > 0; b = best_start_[b]) {
+    pass_end_[--pass] = b;
+  }
+}
+
+unsigned int PassPlanner::Passes() const {
+  return passes_;
+}
+
+unsigned int PassPlanner::PassEnd(unsigned int pass) const {
+  if (pass >= passes_) {
+    return count_;
+  }
+  return pass_end_[pass];
+}
+
+}  // namespace render
@@ -0,0 +1,59 @@
+#ifndef RENDER_PASS_PLANNER_H
+#define RENDER_PASS_PLANNER_H
+
+#include <nds/ndstypes.h>
+
+#include "numeric_types.h"
+#include "project_settings.h"
+
+struct EntityContainer;
+
+namespace render {
+
+class PolygonBudget;
+
+// Decides, once per frame, where each pass of the multipass renderer should
+// end. Filling passes greedily tends to leave a tiny last pass, and to cut
+// through clusters of large objects that then get drawn again in the next pass
+// as overlaps. Instead, this searches every set of cut points through the
+// sorted draw list for the cheapest plan, where each pass costs as much as a
+// full pass worth of polygons, and each polygon drawn again as an overlap
+// costs one more. Polygon counts and the pass budget both come from the
+// renderer's PolygonBudget.
+//
+// Passes over the polygon or object budget aren't ruled out, just made very
+// expensive, so there's always a plan to fall back on even when the budget
+// can't be met; a crowded pass beats dropping the frame.
+//
+// Particles are drawn in whichever pass's depth range they fall in, a polygon
+// each, so they count towards the pass they'll end up in.
+class PassPlanner {
+  public:
+    // Plans passes over list, which must be sorted back to front.
+    // particle_depths must be sorted deepest first.
+    void Plan(const EntityContainer* list, unsigned int count,
+        const PolygonBudget& budget,
+        const numeric_types::fixed* particle_depths = nullptr,
+        unsigned int particle_count = 0);
+
+    unsigned int Passes() const;
+    // Index one past the last draw list entry to draw in this pass.
+    unsigned int PassEnd(unsigned int pass) const;
+
+  private:
+    numeric_types::fixed Plane(const EntityContainer* list, unsigned int index) const;
+
+    unsigned int count_{0};
+    unsigned int passes_{0};
+    u16 pass_end_[MAX_ENTITIES];
+
+    // Scratch space for Plan, indexed by cut point (0 through count).
+    int polygons_before_[MAX_ENTITIES + 1];
+    int overlap_polygons_[MAX_ENTITIES + 1];
+    int best_cost_[MAX_ENTITIES + 1];
+    u16 best_start_[MAX_ENTITIES + 1];
+};
+
+}  // namespace render
+
+#endif  // RENDER_PASS_PLANNER_H
@@ -0,0 +1,131 @@
+#include "render/polygon_budget.h"
+
+#include "dsgx.h"
+
+namespace render {
+
+namespace {
+
+// Budgets never go below this, however badly a pass went; a pass has to fit
+// at least a few entities or the frame never finishes.
+constexpr int kMinBudget = 256;
+// Estimates can run well above the real counts, so the budget is allowed to
+// run well above what the hardware holds.
+constexpr int kMaxBudget = 4 * PolygonBudget::kPolygonCapacity;
+// Passes that used less than this fraction of the target say more about the
+// fixed overhead (the rear plane) than about the estimates.
+constexpr int kMinimumLoadDivisor = 4;
+// How many passes a mesh's cost stands before it's measured again.
+constexpr u32 kSampleInterval = 64;
+
+}  // namespace
+
+static_assert(POLYGON_RAM_TARGET < PolygonBudget::kPolygonCapacity,
+    "POLYGON_RAM_TARGET must leave some headroom below the hardware limit");
+
+PolygonBudget::PolygonBudget() {
+  for (int i = 0; i < POLYGON_BUDGET_WINDOW; i++) {
+    window_[i] = MAX_POLYGONS_PER_PASS;
+  }
+}
+
+int PolygonBudget::PassBudget() const {
+  return budget_;
+}
+
+int PolygonBudget::Cost(const Mesh& mesh) const {
+  if (mesh.measured_cost > 0) {
+    return mesh.measured_cost;
+  }
+  return mesh.draw_cost;
+}
+
+void PolygonBudget::StartPass() {
+  pass_estimate_ = 0;
+  sampled_this_pass_ = false;
+  pass_++;
+}
+
+void PolygonBudget::Drawn(const Mesh& mesh) {
+  pass_estimate_ += Cost(mesh);
+}
+
+void PolygonBudget::Drawn(int polygons) {
+  pass_estimate_ += polygons;
+}
+
+void PolygonBudget::EndPass(int polygons, int vertices) {
+  if (pass_estimate_ <= 0) {
+    return;
+  }
+
+  // Vertex RAM holds three vertices for every polygon slot, so whichever of
+  // the two is fuller is what limits the pass.
+  int load = polygons;
+  const int vertex_load = vertices * kPolygonCapacity / kVertexCapacity;
+  if (vertex_load > load) {
+    load = vertex_load;
+  }
+
+  int candidate;
+  if (polygons >= kPolygonCapacity or vertices >= kVertexCapacity) {
+    // Once RAM is full the counts stop meaning anything, and polygons were
+    // dropped; back off hard from whichever was smaller, the budget or what
+    // was actually sent.
+    overflows_++;
+    candidate = (pass_estimate_ < budget_ ? pass_estimate_ : budget_) * 3 / 4;
+  } else if (load * kMinimumLoadDivisor < POLYGON_RAM_TARGET) {
+    return;
+  } else {
+    // What this pass would have cost, scaled up or down to land on target.
+    candidate = (int)((s64)pass_estimate_ * POLYGON_RAM_TARGET / load);
+  }
+  if (candidate < kMinBudget) {
+    candidate = kMinBudget;
+  }
+  if (candidate > kMaxBudget) {
+    candidate = kMaxBudget;
+  }
+
+  window_[window_cursor_] = candidate;
+  window_cursor_ = (window_cursor_ + 1) % POLYGON_BUDGET_WINDOW;
+
+  // Any of the recent passes could come around again, so plan for the worst.
+  budget_ = window_[0];
+  for (int i = 1; i < POLYGON_BUDGET_WINDOW; i++) {
+    if (window_[i] < budget_) {
+      budget_ = window_[i];
+    }
+  }
+}
+
+bool PolygonBudget::WantsSample(const Mesh& mesh) const {
+  if (sampled_this_pass_) {
+    return false;
+  }
+  return mesh.measured_cost == 0 or
+      pass_ - mesh.cost_sampled_pass >= kSampleInterval;
+}
+
+void PolygonBudget::Sample(Mesh& mesh, int polygons) {
+  sampled_this_pass_ = true;
+  mesh.cost_sampled_pass = pass_;
+  // Nothing drawn means the entity was clipped away entirely, which says
+  // nothing about its cost.
+  if (polygons <= 0) {
+    return;
+  }
+  // How many polygons survive culling depends on which way the mesh faces, so
+  // take a new high right away but let the estimate fall only slowly.
+  if (polygons > mesh.measured_cost) {
+    mesh.measured_cost = polygons;
+  } else {
+    mesh.measured_cost -= (mesh.measured_cost - polygons) / 8;
+  }
+}
+
+int PolygonBudget::Overflows() const {
+  return overflows_;
+}
+
+}  // namespace render
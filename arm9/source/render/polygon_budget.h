@@ -0,0 +1,65 @@
+#ifndef RENDER_POLYGON_BUDGET_H
+#define RENDER_POLYGON_BUDGET_H
+
+#include <nds/ndstypes.h>
+
+#include "project_settings.h"
+
+struct Mesh;
+
+namespace render {
+
+// Keeps the per-pass polygon budget honest. Mesh::draw_cost is a worst case
+// from the exporter, and knows nothing about backface culling or clipping, so
+// a fixed budget either wastes most of each pass or overflows on a bad frame.
+// Instead, the renderer reports how much polygon and vertex RAM each pass
+// actually used, and this works out what budget the last
+// POLYGON_BUDGET_WINDOW passes could have afforded, keeping the smallest.
+//
+// Per-mesh costs are learned too, from the occasional single entity the
+// renderer measures on its own. Costs start at draw_cost until then.
+//
+// Nothing here touches the hardware; the counts are passed in, so this can be
+// driven by a simulated GPU as easily as a real one.
+class PolygonBudget {
+  public:
+    PolygonBudget();
+
+    // Estimated polygons the planner may put in a pass.
+    int PassBudget() const;
+    // Estimated polygons drawing this mesh will cost.
+    int Cost(const Mesh& mesh) const;
+
+    void StartPass();
+    void Drawn(const Mesh& mesh);
+    // For anything drawn without a mesh, such as particles.
+    void Drawn(int polygons);
+    // Call with the polygon and vertex RAM usage once a pass has been sent.
+    void EndPass(int polygons, int vertices);
+
+    // Whether this mesh is due to be measured. At most one mesh is sampled
+    // per pass, since the renderer has to wait for the geometry engine to go
+    // idle on either side of it.
+    bool WantsSample(const Mesh& mesh) const;
+    void Sample(Mesh& mesh, int polygons);
+
+    // Passes that filled polygon or vertex RAM since startup.
+    int Overflows() const;
+
+    static const int kPolygonCapacity = 2048;
+    static const int kVertexCapacity = 6144;
+
+  private:
+    int budget_{MAX_POLYGONS_PER_PASS};
+    int window_[POLYGON_BUDGET_WINDOW];
+    int window_cursor_{0};
+
+    u32 pass_{0};
+    int pass_estimate_{0};
+    bool sampled_this_pass_{false};
+    int overflows_{0};
+};
+
+}  // namespace render
+
+#endif  // RENDER_POLYGON_BUDGET_H
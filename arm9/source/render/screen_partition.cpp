@@ -0,0 +1,98 @@
+#include "render/screen_partition.h"
+
+#include "render/camera_matrix.h"
+#include "render/multipass_renderer.h"
+#include "drawable.h"
+#include "numeric_types.h"
+#include "project_settings.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+
+namespace render {
+
+void ScreenPartition::InitializeRender(MultipassRenderer& renderer) {
+  // Sorted back to front all the same, so that translucent objects blend over
+  // whatever is behind them.
+  renderer.GatherDrawList();
+
+  int polygons = 0;
+  for (unsigned int i = 0; i < renderer.draw_list_count_; i++) {
+    polygons += renderer.polygon_budget_.Cost(
+        *renderer.draw_list_[i].entity->DrawnMesh());
+    renderer.pass_list_[i] = renderer.draw_list_[i];
+  }
+  // Every partition draws from the same list, so it's grouped for animation
+  // patching just once. The draw list itself stays sorted for next frame.
+  polygons += renderer.prepared_particles_;
+  renderer.pass_count_ = renderer.draw_list_count_;
+  renderer.GroupByAnimationFrame(renderer.pass_list_, renderer.pass_count_);
+  partitions_ = PartitionsFor(polygons, renderer.polygon_budget_.PassBudget());
+  for (int i = 0; i < partitions_; i++) {
+    windows_[i] = Window(i, partitions_);
+    frustums_[i].Set(renderer.cached_camera_position_,
+        renderer.cached_camera_subject_, renderer.cached_camera_fov_,
+        0.1_f, 256_f, windows_[i]);
+    projections_[i] = PerspectiveMatrix(0.1_f, 256_f,
+        renderer.cached_camera_fov_, windows_[i]);
+  }
+  next_partition_ = 0;
+}
+
+bool ScreenPartition::DrawPartition(MultipassRenderer& renderer, int partition) {
+  StartPassTopic(partition);
+  const ScreenWindow& window = windows_[partition];
+  const Frustum& frustum = frustums_[partition];
+
+  renderer.LoadProjection(projections_[partition]);
+  SetViewport(window);
+  renderer.ApplyCameraTransform();
+
+  for (unsigned int i = 0; i < renderer.pass_count_; i++) {
+    Drawable* entity = renderer.pass_list_[i].entity;
+    Vec3 center;
+    fixed radius;
+    fixed depth;
+    entity->BoundingSphere(center, radius);
+    if (frustum.TestSphere(center, radius, depth)) {
+      // With the screen split up, entities are usually only partly drawn.
+      renderer.DrawEntity(entity, partitions_ == 1);
+    }
+  }
+
+  next_partition_ = partition + 1;
+  EndPassTopic(partition);
+
+  // Every depth, but only the particles that reach into this window.
+  renderer.DrawPassParticles(0.1_f, 256_f, &frustum);
+  return true;
+}
+
+bool ScreenPartition::FrameComplete(MultipassRenderer& renderer) {
+  return next_partition_ >= partitions_;
+}
+
+void ScreenPartition::EndFrame(MultipassRenderer& renderer) {
+  next_partition_ = partitions_;
+}
+
+ScreenWindow ScreenPartition::PixelWindow(int left, int top, int right, int bottom) {
+  ScreenWindow window;
+  window.left = fixed::FromInt(left - 128) / 128_f;
+  window.right = fixed::FromInt(right - 128) / 128_f;
+  window.top = fixed::FromInt(96 - top) / 96_f;
+  window.bottom = fixed::FromInt(96 - bottom) / 96_f;
+  return window;
+}
+
+void ScreenPartition::SetViewport(const ScreenWindow& window) {
+  // glViewport counts up from the bottom of the screen, and its far edges are
+  // inclusive.
+  const int left = (int)((window.left + 1_f) * 128_f + 0.5_f);
+  const int right = (int)((window.right + 1_f) * 128_f + 0.5_f);
+  const int bottom = (int)((window.bottom + 1_f) * 96_f + 0.5_f);
+  const int top = (int)((window.top + 1_f) * 96_f + 0.5_f);
+  glViewport(left, bottom, right - 1, top - 1);
+}
+
+} // namespace render
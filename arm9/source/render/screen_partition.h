@@ -0,0 +1,54 @@
+#ifndef RENDER_SCREEN_PARTITION_H
+#define RENDER_SCREEN_PARTITION_H
+
+#include <nds.h>
+
+#include "render/frustum.h"
+#include "render/strategy.h"
+
+namespace render {
+
+// Splits the frame by screen area instead of by depth. Each pass narrows the
+// viewport and projection to its own window of the screen and draws everything
+// that reaches into it, over the full depth range, in front of the rear plane
+// holding the windows drawn so far. Every pixel is drawn in exactly
+// one pass, so the depth buffer, fog and translucency all come out the same as
+// a single pass would draw them.
+//
+// Objects that span two windows are drawn in both, but the hardware clips away
+// whatever lands outside the current one, so that only costs their vertices.
+class ScreenPartition : public Strategy {
+  public:
+    using Strategy::Strategy;
+    void InitializeRender(MultipassRenderer& renderer);
+    bool DrawPartition(MultipassRenderer& renderer, int partition);
+    bool FrameComplete(MultipassRenderer& renderer);
+    void EndFrame(MultipassRenderer& renderer);
+
+  protected:
+    static const int kMaxPartitions = 4;
+
+    // How many windows to split a frame with this many polygons into, from 1
+    // to kMaxPartitions, given how many polygons fit in one pass.
+    virtual int PartitionsFor(int polygons, int budget) = 0;
+    // The part of the screen the given partition covers. Windows should line
+    // up with whole pixels.
+    virtual ScreenWindow Window(int partition, int partitions) = 0;
+
+    // A window from a rectangle of pixels; top left is (0, 0), and right and
+    // bottom are exclusive.
+    static ScreenWindow PixelWindow(int left, int top, int right, int bottom);
+
+  private:
+    void SetViewport(const ScreenWindow& window);
+
+    int partitions_{0};
+    int next_partition_{0};
+    ScreenWindow windows_[kMaxPartitions];
+    Frustum frustums_[kMaxPartitions];
+    m4x4 projections_[kMaxPartitions];
+};
+
+} // namespace render
+
+#endif
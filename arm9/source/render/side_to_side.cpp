@@ -0,0 +1,17 @@
+#include "render/side_to_side.h"
+
+namespace render {
+
+SideToSide::SideToSide() : ScreenPartition("Side to Side") {
+}
+
+int SideToSide::PartitionsFor(int polygons, int budget) {
+  return polygons > budget ? 2 : 1;
+}
+
+ScreenWindow SideToSide::Window(int partition, int partitions) {
+  return PixelWindow(256 * partition / partitions, 0,
+      256 * (partition + 1) / partitions, 192);
+}
+
+} // namespace render
@@ -0,0 +1,20 @@
+#ifndef RENDER_SIDE_TO_SIDE_H
+#define RENDER_SIDE_TO_SIDE_H
+
+#include "render/screen_partition.h"
+
+namespace render {
+
+// Splits the screen into its left and right halves, when the frame's polygons
+// don't fit into a single pass.
+class SideToSide : public ScreenPartition {
+  public:
+    SideToSide();
+  protected:
+    int PartitionsFor(int polygons, int budget);
+    ScreenWindow Window(int partition, int partitions);
+};
+
+} // namespace render
+
+#endif
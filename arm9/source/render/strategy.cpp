@@ -0,0 +1,38 @@
+#include "render/strategy.h"
+
+#include "debug/profiler.h"
+
+namespace render {
+
+Strategy::Strategy(const std::string& name) : name_{name} {
+  for (int i = 0; i < kTimedPasses; i++) {
+    pass_topics_[i] = debug::Profiler::RegisterTopic(
+        "Engine: " + name + ": Pass " + std::to_string(i + 1));
+  }
+}
+
+const std::string& Strategy::name() const {
+  return name_;
+}
+
+void Strategy::ClearPassTopics(bool all) {
+  for (int i = all ? 0 : timed_passes_; i < kTimedPasses; i++) {
+    debug::Profiler::ClearTopic(pass_topics_[i]);
+  }
+  timed_passes_ = 0;
+}
+
+void Strategy::StartPassTopic(int partition) {
+  if (partition < kTimedPasses) {
+    debug::Profiler::StartTopic(pass_topics_[partition]);
+  }
+}
+
+void Strategy::EndPassTopic(int partition) {
+  if (partition < kTimedPasses) {
+    debug::Profiler::EndTopic(pass_topics_[partition]);
+    timed_passes_ = partition + 1;
+  }
+}
+
+} // namespace render
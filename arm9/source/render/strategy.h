@@ -1,14 +1,47 @@
 #ifndef RENDER_STRATEGY_H
 #define RENDER_STRATEGY_H
 
+#include <string>
+
 class MultipassRenderer;
 
 namespace render {
 
+// Decides how a frame is split up into passes, and draws them. The renderer
+// takes care of everything shared between strategies: capturing each pass,
+// compositing it with the last, and presenting the finished frame.
 class Strategy {
   public:
+    explicit Strategy(const std::string& name);
+    virtual ~Strategy() {}
+
+    // Called at the start of each frame, after the camera has been cached.
     virtual void InitializeRender(MultipassRenderer& renderer) = 0;
-    virtual void DrawPartition(MultipassRenderer& renderer, int partition, bool last_partition) = 0;
+    // Sets up and draws one pass. Returns false if the frame had to be dropped
+    // partway through, in which case the strategy has already reset it.
+    virtual bool DrawPartition(MultipassRenderer& renderer, int partition) = 0;
+    // True once every pass of the frame has been drawn.
+    virtual bool FrameComplete(MultipassRenderer& renderer) = 0;
+    // Skips whatever passes are left in the frame.
+    virtual void EndFrame(MultipassRenderer& renderer) = 0;
+
+    const std::string& name() const;
+
+    // Passes beyond this many aren't timed.
+    static const int kTimedPasses = 5;
+
+    // Clears the timings of any passes that weren't drawn last frame, or of
+    // every pass if all is set.
+    void ClearPassTopics(bool all = false);
+
+  protected:
+    void StartPassTopic(int partition);
+    void EndPassTopic(int partition);
+
+  private:
+    std::string name_;
+    int pass_topics_[kTimedPasses];
+    int timed_passes_{0};
 };
 
 } // namespace render
@@ -0,0 +1,24 @@
+#include "render/top_to_bottom.h"
+
+namespace render {
+
+TopToBottom::TopToBottom() : ScreenPartition("Top to Bottom") {
+}
+
+int TopToBottom::PartitionsFor(int polygons, int budget) {
+  int partitions = (polygons + budget - 1) / budget;
+  if (partitions < 1) {
+    partitions = 1;
+  }
+  if (partitions > kMaxPartitions) {
+    partitions = kMaxPartitions;
+  }
+  return partitions;
+}
+
+ScreenWindow TopToBottom::Window(int partition, int partitions) {
+  return PixelWindow(0, 192 * partition / partitions,
+      256, 192 * (partition + 1) / partitions);
+}
+
+} // namespace render
@@ -0,0 +1,20 @@
+#ifndef RENDER_TOP_TO_BOTTOM_H
+#define RENDER_TOP_TO_BOTTOM_H
+
+#include "render/screen_partition.h"
+
+namespace render {
+
+// Splits the screen into horizontal bands of scanlines, top to bottom; as
+// many as it takes to fit the frame's polygons into the per-pass budget.
+class TopToBottom : public ScreenPartition {
+  public:
+    TopToBottom();
+  protected:
+    int PartitionsFor(int polygons, int budget);
+    ScreenWindow Window(int partition, int partitions);
+};
+
+} // namespace render
+
+#endif
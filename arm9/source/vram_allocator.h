@@ -100,6 +100,9 @@ class VramAllocator {
         return T{};
       }
     }
+    bool Contains(std::string name) {
+      return loaded_assets.count(name) > 0;
+    }
     T Retrieve(std::string name) {
       if (loaded_assets.count(name) > 0) {
         return loaded_assets[name];
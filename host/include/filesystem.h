@@ -0,0 +1,7 @@
+#ifndef HOST_FILESYSTEM_H
+#define HOST_FILESYSTEM_H
+
+// NitroFS paths are relative to the working directory on the host.
+static inline bool nitroFSInit(char**) { return true; }
+
+#endif  // HOST_FILESYSTEM_H
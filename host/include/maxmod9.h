@@ -0,0 +1,25 @@
+#ifndef HOST_MAXMOD9_H
+#define HOST_MAXMOD9_H
+
+#include "nds/ndstypes.h"
+
+typedef u32 mm_word;
+typedef u32 mm_sfxhand;
+typedef u8 mm_byte;
+typedef u16 mm_hword;
+
+typedef struct t_mmsoundeffect {
+  mm_word id;
+  mm_hword rate;
+  mm_sfxhand handle;
+  mm_byte volume;
+  mm_byte panning;
+} mm_sound_effect;
+
+// Silence.
+static inline void mmInitDefaultMem(void*) {}
+static inline void mmLoadEffect(mm_word) {}
+static inline mm_sfxhand mmEffect(mm_word) { return 0; }
+static inline mm_sfxhand mmEffectEx(mm_sound_effect*) { return 0; }
+
+#endif  // HOST_MAXMOD9_H
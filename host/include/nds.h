@@ -0,0 +1,23 @@
+#ifndef HOST_NDS_H
+#define HOST_NDS_H
+
+// A small stand-in for libnds, covering just enough of it to build the game's
+// simulation code natively. See host/README.md.
+
+#include "nds/ndstypes.h"
+#include "nds/registers.h"
+#include "nds/debug.h"
+#include "nds/dma.h"
+#include "nds/interrupts.h"
+#include "nds/system.h"
+#include "nds/timers.h"
+#include "nds/arm9/background.h"
+#include "nds/arm9/console.h"
+#include "nds/arm9/input.h"
+#include "nds/arm9/math.h"
+#include "nds/arm9/sprite.h"
+#include "nds/arm9/trig_lut.h"
+#include "nds/arm9/video.h"
+#include "nds/arm9/videoGL.h"
+
+#endif  // HOST_NDS_H
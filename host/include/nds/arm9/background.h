@@ -0,0 +1,30 @@
+#ifndef HOST_NDS_ARM9_BACKGROUND_H
+#define HOST_NDS_ARM9_BACKGROUND_H
+
+#include "nds/arm9/video.h"
+
+typedef enum {
+  BgType_Text8bpp,
+  BgType_Text4bpp,
+  BgType_Rotation,
+  BgType_ExRotation,
+  BgType_Bmp8,
+  BgType_Bmp16
+} BgType;
+
+typedef enum {
+  BgSize_R_128x128,
+  BgSize_T_256x256,
+  BgSize_B16_256x256,
+  BgSize_B8_256x256
+} BgSize;
+
+static inline int bgInit(int, BgType, BgSize, int, int) { return 0; }
+static inline int bgInitSub(int, BgType, BgSize, int, int) { return 0; }
+static inline void bgSetPriority(int, unsigned int) {}
+static inline void bgHide(int) {}
+static inline void bgShow(int) {}
+static inline u16* bgGetGfxPtr(int) { return BG_GFX_SUB; }
+static inline u16* bgGetMapPtr(int) { return BG_GFX_SUB; }
+
+#endif  // HOST_NDS_ARM9_BACKGROUND_H
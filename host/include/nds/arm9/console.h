@@ -0,0 +1,13 @@
+#ifndef HOST_NDS_ARM9_CONSOLE_H
+#define HOST_NDS_ARM9_CONSOLE_H
+
+#include "nds/arm9/background.h"
+
+typedef struct PrintConsole PrintConsole;
+
+static inline PrintConsole* consoleInit(PrintConsole*, int, BgType, BgSize, int,
+                                        int, bool, bool) {
+  return nullptr;
+}
+
+#endif  // HOST_NDS_ARM9_CONSOLE_H
@@ -0,0 +1,40 @@
+#ifndef HOST_NDS_ARM9_INPUT_H
+#define HOST_NDS_ARM9_INPUT_H
+
+#include <string.h>
+
+#include "nds/ndstypes.h"
+
+#define KEY_A BIT(0)
+#define KEY_B BIT(1)
+#define KEY_SELECT BIT(2)
+#define KEY_START BIT(3)
+#define KEY_RIGHT BIT(4)
+#define KEY_LEFT BIT(5)
+#define KEY_UP BIT(6)
+#define KEY_DOWN BIT(7)
+#define KEY_R BIT(8)
+#define KEY_L BIT(9)
+#define KEY_X BIT(10)
+#define KEY_Y BIT(11)
+#define KEY_TOUCH BIT(12)
+
+typedef struct touchPosition {
+  u16 rawx;
+  u16 rawy;
+  u16 px;
+  u16 py;
+  u16 z1;
+  u16 z2;
+} touchPosition;
+
+// Nobody is holding the buttons on a build box.
+static inline void scanKeys() {}
+static inline u32 keysHeld() { return 0; }
+static inline u32 keysDown() { return 0; }
+static inline u32 keysUp() { return 0; }
+static inline void touchRead(touchPosition* touch) {
+  memset(touch, 0, sizeof(*touch));
+}
+
+#endif  // HOST_NDS_ARM9_INPUT_H
@@ -0,0 +1,21 @@
+#ifndef HOST_NDS_ARM9_MATH_H
+#define HOST_NDS_ARM9_MATH_H
+
+#include <math.h>
+
+#include "nds/ndstypes.h"
+
+// The DS does these with its hardware divider and square root units; the
+// results here match to within the last bit.
+static inline s32 divf32(s32 num, s32 den) { return (s32)(((s64)num << 12) / den); }
+static inline s32 mulf32(s32 a, s32 b) { return (s32)(((s64)a * b) >> 12); }
+static inline s32 sqrtf32(s32 a) { return (s32)(sqrt((double)a / 4096.0) * 4096.0); }
+static inline s32 div32(s32 num, s32 den) { return num / den; }
+static inline s32 mod32(s32 num, s32 den) { return num % den; }
+static inline u32 sqrt32(int a) { return (u32)sqrt((double)a); }
+
+#define inttof32(n) ((n) << 12)
+#define floattof32(n) ((s32)((n) * (1 << 12)))
+#define f32toint(n) ((n) >> 12)
+
+#endif  // HOST_NDS_ARM9_MATH_H
@@ -0,0 +1,6 @@
+#ifndef HOST_NDS_ARM9_POSTEST_H
+#define HOST_NDS_ARM9_POSTEST_H
+
+#include "nds/arm9/videoGL.h"
+
+#endif  // HOST_NDS_ARM9_POSTEST_H
@@ -0,0 +1,44 @@
+#ifndef HOST_NDS_ARM9_SPRITE_H
+#define HOST_NDS_ARM9_SPRITE_H
+
+#include "nds/ndstypes.h"
+
+typedef struct OamState {
+  int unused;
+} OamState;
+
+extern OamState oamMain;
+extern OamState oamSub;
+
+typedef enum {
+  SpriteSize_8x8,
+  SpriteSize_16x16,
+  SpriteSize_32x32,
+  SpriteSize_64x64,
+  SpriteSize_16x8,
+  SpriteSize_32x8,
+  SpriteSize_32x16,
+  SpriteSize_64x32,
+  SpriteSize_8x16,
+  SpriteSize_8x32,
+  SpriteSize_16x32,
+  SpriteSize_32x64
+} SpriteSize;
+
+typedef enum {
+  SpriteColorFormat_16Color,
+  SpriteColorFormat_256Color,
+  SpriteColorFormat_Bmp
+} SpriteColorFormat;
+
+typedef enum { SpriteMapping_1D_32, SpriteMapping_1D_128 } SpriteMapping;
+
+static inline void oamInit(OamState*, SpriteMapping, bool) {}
+static inline void oamUpdate(OamState*) {}
+static inline void oamSet(OamState*, int, int, int, int, int, SpriteSize,
+                          SpriteColorFormat, const void*, int, bool, bool, bool,
+                          bool, bool) {}
+static inline void oamClear(OamState*, int, int) {}
+static inline void oamSetXY(OamState*, int, int, int) {}
+
+#endif  // HOST_NDS_ARM9_SPRITE_H
@@ -0,0 +1,30 @@
+#ifndef HOST_NDS_ARM9_TRIG_LUT_H
+#define HOST_NDS_ARM9_TRIG_LUT_H
+
+#include <math.h>
+
+#include "nds/ndstypes.h"
+
+#define DEGREES_IN_CIRCLE (1 << 15)
+#define degreesToAngle(degrees) ((degrees) * DEGREES_IN_CIRCLE / 360)
+#define angleToDegrees(angle) ((angle) * 360 / DEGREES_IN_CIRCLE)
+
+// libnds interpolates a lookup table; computing these directly can differ
+// from hardware by a bit or so.
+static inline s16 sinLerp(s16 angle) {
+  return (s16)lround(sin(angle * 2 * M_PI / DEGREES_IN_CIRCLE) * 4096.0);
+}
+static inline s16 cosLerp(s16 angle) {
+  return (s16)lround(cos(angle * 2 * M_PI / DEGREES_IN_CIRCLE) * 4096.0);
+}
+static inline s32 tanLerp(s16 angle) {
+  return (s32)lround(tan(angle * 2 * M_PI / DEGREES_IN_CIRCLE) * 4096.0);
+}
+static inline s16 asinLerp(s16 par) {
+  return (s16)lround(asin(par / 4096.0) * DEGREES_IN_CIRCLE / (2 * M_PI));
+}
+static inline s16 acosLerp(s16 par) {
+  return (s16)lround(acos(par / 4096.0) * DEGREES_IN_CIRCLE / (2 * M_PI));
+}
+
+#endif  // HOST_NDS_ARM9_TRIG_LUT_H
@@ -0,0 +1,61 @@
+#ifndef HOST_NDS_ARM9_VIDEO_H
+#define HOST_NDS_ARM9_VIDEO_H
+
+#include "nds/ndstypes.h"
+#include "nds/registers.h"
+
+#define RGB15(r, g, b) ((r) | ((g) << 5) | ((b) << 10))
+#define RGB5(r, g, b) ((r) | ((g) << 5) | ((b) << 10))
+
+#define MODE_0_2D 0x10000
+#define MODE_5_2D 0x10005
+#define MODE_0_3D 0x10100
+#define MODE_3_3D 0x10103
+
+#define DCAP_ENABLE BIT(31)
+#define DCAP_BANK(n) ((n) << 16)
+#define DCAP_SIZE(n) ((n) << 20)
+#define DCAP_SRC(n) ((n) << 24)
+
+// Video memory, backed by plain arrays.
+extern u16 host_vram[8][0x10000];
+
+#define VRAM_A (host_vram[0])
+#define VRAM_B (host_vram[1])
+#define VRAM_C (host_vram[2])
+#define VRAM_D (host_vram[3])
+#define VRAM_G (host_vram[4])
+#define SPRITE_GFX_SUB (host_vram[5])
+#define BG_GFX_SUB (host_vram[6])
+#define BG_PALETTE_SUB (host_vram[7])
+#define SPRITE_PALETTE_SUB (host_vram[7])
+
+typedef enum { VRAM_A_LCD, VRAM_A_TEXTURE_SLOT0 } VRAM_A_TYPE;
+typedef enum { VRAM_B_LCD, VRAM_B_TEXTURE_SLOT0 } VRAM_B_TYPE;
+typedef enum { VRAM_C_LCD, VRAM_C_TEXTURE, VRAM_C_SUB_BG } VRAM_C_TYPE;
+typedef enum {
+  VRAM_D_LCD,
+  VRAM_D_MAIN_BG_0x06000000,
+  VRAM_D_SUB_SPRITE
+} VRAM_D_TYPE;
+typedef enum { VRAM_G_LCD, VRAM_G_TEX_PALETTE } VRAM_G_TYPE;
+typedef enum { VRAM_H_SUB_BG, VRAM_H_LCD } VRAM_H_TYPE;
+typedef enum {
+  VRAM_I_SUB_SPRITE,
+  VRAM_I_LCD,
+  VRAM_I_SUB_SPRITE_EXT_PALETTE
+} VRAM_I_TYPE;
+
+static inline u32 vramSetBankA(VRAM_A_TYPE) { return 0; }
+static inline u32 vramSetBankB(VRAM_B_TYPE) { return 0; }
+static inline u32 vramSetBankC(VRAM_C_TYPE) { return 0; }
+static inline u32 vramSetBankD(VRAM_D_TYPE) { return 0; }
+static inline u32 vramSetBankG(VRAM_G_TYPE) { return 0; }
+static inline u32 vramSetBankH(VRAM_H_TYPE) { return 0; }
+static inline u32 vramSetBankI(VRAM_I_TYPE) { return 0; }
+
+static inline void videoSetMode(u32) {}
+static inline void videoSetModeSub(u32) {}
+static inline void setBrightness(int, int) {}
+
+#endif  // HOST_NDS_ARM9_VIDEO_H
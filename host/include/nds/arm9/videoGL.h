@@ -0,0 +1,127 @@
+#ifndef HOST_NDS_ARM9_VIDEOGL_H
+#define HOST_NDS_ARM9_VIDEOGL_H
+
+#include "nds/ndstypes.h"
+#include "nds/registers.h"
+#include "nds/arm9/video.h"
+
+typedef struct m4x4 {
+  int32 m[16];
+} m4x4;
+
+typedef struct m4x3 {
+  int32 m[12];
+} m4x3;
+
+#define inttot16(n) ((n) << 4)
+#define floattov16(n) ((v16)((n) * (1 << 12)))
+#define floattov10(n) ((v10)((n) * (1 << 9)))
+#define TEXTURE_PACK(u, v) (((u) & 0xFFFF) | ((v) << 16))
+
+#define POLY_ALPHA(n) ((n) << 16)
+#define POLY_ID(n) ((n) << 24)
+#define POLY_CULL_BACK (2 << 6)
+#define POLY_CULL_NONE (3 << 6)
+#define POLY_FOG (1 << 15)
+
+#define GL_TRIANGLE 0
+#define GL_QUAD 1
+#define GL_PROJECTION 0
+#define GL_POSITION 1
+#define GL_MODELVIEW 2
+#define GL_TEXTURE_2D (1 << 0)
+#define GL_BLEND (1 << 3)
+#define GL_OUTLINE (1 << 5)
+#define GL_FOG (1 << 7)
+#define GL_WBUFFERING 2
+
+#define TEXGEN_TEXCOORD 0
+#define GL_TEXTURE_WRAP_S 0
+#define GL_TEXTURE_WRAP_T 0
+#define TEXTURE_SIZE_DEFAULT 0
+
+enum GL_TEXTURE_TYPE_ENUM {
+  GL_NOTEXTURE = 0,
+  GL_RGB32_A3 = 1,
+  GL_RGB4 = 2,
+  GL_RGB16 = 3,
+  GL_RGB256 = 4,
+  GL_COMPRESSED = 5,
+  GL_RGB8_A5 = 6,
+  GL_RGBA = 7,
+  GL_RGB = 8
+};
+
+enum GL_TEXTURE_SIZE_ENUM {
+  TEXTURE_SIZE_8 = 0,
+  TEXTURE_SIZE_16,
+  TEXTURE_SIZE_32,
+  TEXTURE_SIZE_64,
+  TEXTURE_SIZE_128,
+  TEXTURE_SIZE_256,
+  TEXTURE_SIZE_512,
+  TEXTURE_SIZE_1024
+};
+
+// Nothing is ever drawn on the host; the geometry engine calls are no-ops.
+static inline int glInit() { return 1; }
+static inline void glEnable(int) {}
+static inline void glDisable(int) {}
+static inline void glFlush(u32) {}
+static inline void glViewport(u8, u8, u8, u8) {}
+static inline void glClearColor(u8, u8, u8, u8) {}
+static inline void glClearDepth(u16) {}
+static inline void glClearPolyID(u8) {}
+static inline void glFogColor(u8, u8, u8, u8) {}
+static inline void glFogOffset(int) {}
+static inline void glFogShift(int) {}
+static inline void glFogDensity(int, int) {}
+static inline void glLight(int, rgb, v10, v10, v10) {}
+static inline void glMaterialShinyness() {}
+
+static inline void glMatrixMode(int) {}
+static inline void glLoadIdentity() {}
+static inline void glPushMatrix() {}
+static inline void glPopMatrix(int) {}
+static inline void glTranslatef32(int, int, int) {}
+static inline void glScalef32(int, int, int) {}
+static inline void glTranslatef(float, float, float) {}
+static inline void glScalef(float, float, float) {}
+static inline void glRotateXi(int) {}
+static inline void glRotateYi(int) {}
+static inline void glRotateZi(int) {}
+static inline void gluLookAt(float, float, float, float, float, float, float,
+                             float, float) {}
+static inline void gluLookAtf32(int, int, int, int, int, int, int, int, int) {}
+static inline void gluPerspective(float, float, float, float) {}
+static inline void glOrtho(float, float, float, float, float, float) {}
+
+static inline void glCallList(const u32*) {}
+static inline void glPolyFmt(u32) {}
+static inline void glColor3b(u8, u8, u8) {}
+static inline void glColor(rgb) {}
+static inline void glBegin(int) {}
+static inline void glEnd() {}
+static inline void glVertex3v16(v16, v16, v16) {}
+static inline void glTexCoord2t16(t16, t16) {}
+
+static inline int glGenTextures(int, int*) { return 1; }
+static inline void glBindTexture(int, int) {}
+static inline void glTexParameter(int, int) {}
+static inline int glTexImage2D(int, int, int, int, int, int, int, const void*) {
+  return 1;
+}
+static inline int glColorTableEXT(int, int, int, int, int, const u16*) {
+  return 1;
+}
+
+// Visibility tests always pass, with everything sitting one unit in front of
+// the camera.
+static inline int BoxTest(s32, s32, s32, s32, s32, s32) { return 1; }
+static inline void PosTest(s32, s32, s32) {}
+static inline s32 PosTestWresult() { return 1 << 12; }
+static inline s32 PosTestXresult() { return 0; }
+static inline s32 PosTestYresult() { return 0; }
+static inline s32 PosTestZresult() { return 0; }
+
+#endif  // HOST_NDS_ARM9_VIDEOGL_H
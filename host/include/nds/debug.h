@@ -0,0 +1,7 @@
+#ifndef HOST_NDS_DEBUG_H
+#define HOST_NDS_DEBUG_H
+
+// Emulators print these; the host build sends them to stderr.
+void nocashMessage(const char* message);
+
+#endif  // HOST_NDS_DEBUG_H
@@ -0,0 +1,12 @@
+#ifndef HOST_NDS_DMA_H
+#define HOST_NDS_DMA_H
+
+#include <string.h>
+
+#include "nds/ndstypes.h"
+
+static inline void dmaCopy(const void* source, void* dest, u32 size) {
+  memmove(dest, source, size);
+}
+
+#endif  // HOST_NDS_DMA_H
@@ -0,0 +1,22 @@
+#ifndef HOST_NDS_INTERRUPTS_H
+#define HOST_NDS_INTERRUPTS_H
+
+#include "nds/ndstypes.h"
+#include "nds/registers.h"
+
+#define IRQ_VBLANK BIT(0)
+#define IRQ_HBLANK BIT(1)
+#define IRQ_VCOUNT BIT(2)
+#define IRQ_TIMER0 BIT(3)
+
+// Where the BIOS's IntrWait looks for interrupts that have already happened.
+#define INTR_WAIT_FLAGS HOST_REG32(4)
+
+// There's no display to wait on, so waits return immediately.
+static inline void irqEnable(u32) {}
+static inline void irqDisable(u32) {}
+static inline void irqSet(u32, void (*)()) {}
+static inline void swiIntrWait(int, u32) {}
+static inline void swiWaitForVBlank() {}
+
+#endif  // HOST_NDS_INTERRUPTS_H
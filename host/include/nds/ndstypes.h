@@ -0,0 +1,30 @@
+#ifndef HOST_NDS_NDSTYPES_H
+#define HOST_NDS_NDSTYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef volatile u8 vu8;
+typedef volatile u16 vu16;
+typedef volatile u32 vu32;
+typedef volatile s16 vs16;
+typedef volatile s32 vs32;
+
+typedef s32 int32;
+typedef s16 t16;
+typedef s16 v16;
+typedef s16 v10;
+typedef u16 rgb;
+
+#define BIT(n) (1 << (n))
+
+#endif  // HOST_NDS_NDSTYPES_H
@@ -0,0 +1,44 @@
+#ifndef HOST_NDS_REGISTERS_H
+#define HOST_NDS_REGISTERS_H
+
+#include "nds/ndstypes.h"
+
+// Memory mapped registers are backed by plain memory on the host. Writes go
+// nowhere, and reads return whatever was last written (zero by default).
+extern u32 host_registers[64];
+
+#define HOST_REG32(index) (*(volatile u32*)&host_registers[index])
+#define HOST_REG16(index) (*(volatile u16*)&host_registers[index])
+
+#define REG_VCOUNT HOST_REG16(0)
+#define REG_DISPCAPCNT HOST_REG32(1)
+#define REG_DISPCNT HOST_REG32(2)
+#define REG_IME HOST_REG32(3)
+
+#define MATRIX_CONTROL HOST_REG32(8)
+#define MATRIX_PUSH HOST_REG32(9)
+#define MATRIX_POP HOST_REG32(10)
+#define MATRIX_IDENTITY HOST_REG32(11)
+#define MATRIX_LOAD4x4 HOST_REG32(12)
+#define MATRIX_LOAD4x3 HOST_REG32(13)
+#define MATRIX_MULT4x4 HOST_REG32(14)
+#define MATRIX_MULT4x3 HOST_REG32(15)
+#define MATRIX_TRANSLATE HOST_REG32(16)
+#define MATRIX_SCALE HOST_REG32(17)
+
+#define GFX_BEGIN HOST_REG32(20)
+#define GFX_END HOST_REG32(21)
+#define GFX_COLOR HOST_REG32(22)
+#define GFX_VERTEX16 HOST_REG32(23)
+#define GFX_TEX_COORD HOST_REG32(24)
+#define GFX_TEX_FORMAT HOST_REG32(25)
+#define GFX_PAL_FORMAT HOST_REG32(26)
+#define GFX_POLY_FORMAT HOST_REG32(27)
+#define GFX_FLUSH HOST_REG32(28)
+#define GFX_VIEWPORT HOST_REG32(29)
+#define GFX_CLEAR_COLOR HOST_REG32(30)
+#define GFX_STATUS HOST_REG32(31)
+#define GFX_POLYGON_RAM_USAGE HOST_REG16(32)
+#define GFX_VERTEX_RAM_USAGE HOST_REG16(33)
+
+#endif  // HOST_NDS_REGISTERS_H
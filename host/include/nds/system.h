@@ -0,0 +1,6 @@
+#ifndef HOST_NDS_SYSTEM_H
+#define HOST_NDS_SYSTEM_H
+
+#include "nds/interrupts.h"
+
+#endif  // HOST_NDS_SYSTEM_H
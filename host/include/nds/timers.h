@@ -0,0 +1,15 @@
+#ifndef HOST_NDS_TIMERS_H
+#define HOST_NDS_TIMERS_H
+
+#include "nds/ndstypes.h"
+
+// The DS's bus clock, which cpuGetTiming counts in.
+#define BUS_CLOCK (33513982)
+
+// Backed by the host's monotonic clock, scaled to BUS_CLOCK ticks so profiler
+// numbers read the same as they do on hardware.
+void cpuStartTiming(int timer);
+u32 cpuGetTiming();
+u32 cpuEndTiming();
+
+#endif  // HOST_NDS_TIMERS_H
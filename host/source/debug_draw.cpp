@@ -0,0 +1,13 @@
+#include "debug/utilities.h"
+
+// There's nothing to draw debug shapes onto in a headless build, and the real
+// implementations drag in the whole renderer.
+
+void debug::DrawCircle(Vec3, numeric_types::fixed, rgb, u32) {
+}
+
+void debug::DrawLine(Vec3, Vec3, rgb) {
+}
+
+void debug::DrawLine(Vec2, Vec2, rgb) {
+}
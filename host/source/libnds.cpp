@@ -0,0 +1,33 @@
+#include <nds.h>
+
+#include <chrono>
+#include <cstdio>
+
+u32 host_registers[64];
+u16 host_vram[8][0x10000];
+
+OamState oamMain;
+OamState oamSub;
+
+void nocashMessage(const char* message) {
+  fputs(message, stderr);
+}
+
+namespace {
+  std::chrono::steady_clock::time_point timing_start;
+}
+
+void cpuStartTiming(int) {
+  timing_start = std::chrono::steady_clock::now();
+}
+
+u32 cpuGetTiming() {
+  auto elapsed = std::chrono::steady_clock::now() - timing_start;
+  auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return (u32)((u64)nanoseconds * BUS_CLOCK / 1000000000ull);
+}
+
+u32 cpuEndTiming() {
+  return cpuGetTiming();
+}
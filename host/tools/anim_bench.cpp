@@ -0,0 +1,225 @@
+// Replays a squad of pikmin walking, each a few frames apart in the walk
+// cycle, through Dsgx::ApplyAnimation, and compares it with the interpreted
+// loop it used to run: the channel / offset list walk with a branch on
+// word_count per channel. Both write into their own copy of the display list,
+// which are checked against each other after every draw.
+//
+// A third run draws each tick's squad the way the renderer does since
+// grouping by animation frame: in frame order, skipping the patch whenever the
+// display list already holds the frame.
+//
+// Usage: anim_bench [--pikmin=N] [--ticks=N] [--animation=NAME] file.dsgx
+//
+// Without --animation, the first animation with "Walk" in its name is used,
+// or failing that the first one.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nds.h>
+
+#include "dsgx.h"
+#include "load_file.h"
+
+namespace {
+
+struct Options {
+  int pikmin = 100;
+  int ticks = 600;
+  std::string animation;
+  const char* filename = nullptr;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--pikmin=", 9) == 0) {
+      options.pikmin = atoi(argv[i] + 9);
+    } else if (strncmp(argv[i], "--ticks=", 8) == 0) {
+      options.ticks = atoi(argv[i] + 8);
+    } else if (strncmp(argv[i], "--animation=", 12) == 0) {
+      options.animation = argv[i] + 12;
+    } else if (options.filename == nullptr and argv[i][0] != '-') {
+      options.filename = argv[i];
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return options.filename != nullptr;
+}
+
+struct Counts {
+  u64 draws = 0;
+  u64 patches = 0;
+  u64 words = 0;
+  u64 runs = 0;
+  double seconds = 0.0;
+};
+
+// The loop ApplyAnimation ran before it was compiled, counting as it goes.
+void InterpretedApply(const Animation& animation, u32 frame, u32* destination,
+    Counts& counts) {
+  for (auto& channel : animation.channels) {
+    auto& ref = channel.first;
+    auto& data = channel.second;
+    u32 const* current_data = data.data;
+    current_data += ref.num_references * data.word_count * frame;
+    if (data.word_count == 1) {
+      for (auto offset_list = ref.offset_lists.begin(); offset_list != ref.offset_lists.end(); offset_list++) {
+        for (u32 i = 0; i < offset_list->num_offsets; i++) {
+            *((u32*)(destination + offset_list->offsets[i])) = *current_data;
+        }
+        counts.runs += offset_list->num_offsets;
+        counts.words += offset_list->num_offsets;
+        current_data++;
+      }
+    } else {
+      for (auto offset_list = ref.offset_lists.begin(); offset_list != ref.offset_lists.end(); offset_list++) {
+        for (u32 i = 0; i < offset_list->num_offsets; i++) {
+          for (u32 d = 0; d < data.word_count; d++) {
+            *((u32*)(destination + offset_list->offsets[i] + d)) = current_data[d];
+          }
+        }
+        counts.runs += offset_list->num_offsets;
+        counts.words += offset_list->num_offsets * data.word_count;
+        current_data += data.word_count;
+      }
+    }
+  }
+}
+
+u64 CompiledWords(const Animation& animation) {
+  u64 words = 0;
+  for (auto& run : animation.runs) {
+    words += run.count;
+  }
+  return words;
+}
+
+// Where each pikmin is in the cycle on this tick.
+u32 FrameOf(int pikmin, int tick, u32 frames) {
+  return (u32)(pikmin * 7 + tick) % frames;
+}
+
+double Seconds(std::chrono::steady_clock::duration elapsed) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(
+      elapsed).count();
+}
+
+void Report(const char* name, const Counts& counts) {
+  const double draws = counts.draws ? (double)counts.draws : 1.0;
+  printf("%-26s %10.1f %10.1f %10.1f %12.1f\n", name,
+         counts.patches / draws, counts.words / draws, counts.runs / draws,
+         counts.seconds * 1e9 / draws);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    fprintf(stderr, "Usage: %s [--pikmin=N] [--ticks=N] [--animation=NAME] "
+            "file.dsgx\n", argv[0]);
+    return 1;
+  }
+
+  u32 length = 0;
+  std::vector<u32> data = tools::LoadFile(options.filename, length);
+  if (data.empty()) {
+    fprintf(stderr, "Couldn't load %s\n", options.filename);
+    return 1;
+  }
+  // Dsgx keeps pointers into the data it was given, so it has to outlive it.
+  Dsgx dsgx(data.data(), length);
+  Mesh* mesh = dsgx.DefaultMesh();
+
+  Animation* animation = nullptr;
+  for (auto& entry : mesh->animations) {
+    const bool wanted = options.animation.empty() ?
+        entry.first.find("Walk") != std::string::npos :
+        entry.first == options.animation;
+    if (wanted) {
+      animation = &entry.second;
+      break;
+    }
+  }
+  if (animation == nullptr and options.animation.empty() and
+      not mesh->animations.empty()) {
+    animation = &mesh->animations.begin()->second;
+  }
+  if (animation == nullptr or animation->frame_length == 0) {
+    fprintf(stderr, "No animation to replay on %s\n", mesh->name);
+    return 1;
+  }
+  const u32 frames = animation->frame_length;
+
+  const u32 list_words = mesh->model_data[0] + 1;
+  std::vector<u32> interpreted_list(mesh->model_data,
+                                    mesh->model_data + list_words);
+  Counts interpreted;
+  Counts compiled;
+  Counts grouped;
+  int mismatches = 0;
+
+  for (int tick = 0; tick < options.ticks; tick++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.pikmin; i++) {
+      InterpretedApply(*animation, FrameOf(i, tick, frames),
+                       interpreted_list.data() + 1, interpreted);
+    }
+    interpreted.seconds += Seconds(std::chrono::steady_clock::now() - start);
+    interpreted.draws += options.pikmin;
+    interpreted.patches += options.pikmin;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.pikmin; i++) {
+      dsgx.ApplyAnimation(animation, FrameOf(i, tick, frames), mesh);
+    }
+    compiled.seconds += Seconds(std::chrono::steady_clock::now() - start);
+    compiled.draws += options.pikmin;
+    compiled.patches += options.pikmin;
+    compiled.words += CompiledWords(*animation) * options.pikmin;
+    compiled.runs += animation->runs.size() * options.pikmin;
+
+    // Both ended on the last pikmin's frame.
+    if (memcmp(interpreted_list.data(), mesh->model_data,
+               list_words * sizeof(u32)) != 0) {
+      mismatches++;
+    }
+
+    std::vector<u32> order;
+    for (int i = 0; i < options.pikmin; i++) {
+      order.push_back(FrameOf(i, tick, frames));
+    }
+    std::sort(order.begin(), order.end());
+    start = std::chrono::steady_clock::now();
+    for (u32 frame : order) {
+      if (mesh->applied_animation != animation or
+          mesh->applied_frame != frame) {
+        dsgx.ApplyAnimation(animation, frame, mesh);
+        grouped.patches++;
+        grouped.words += CompiledWords(*animation);
+        grouped.runs += animation->runs.size();
+      }
+    }
+    grouped.seconds += Seconds(std::chrono::steady_clock::now() - start);
+    grouped.draws += options.pikmin;
+  }
+
+  printf("%s: %s, %u frames, %d channels, %u words per display list\n",
+         mesh->name, animation->name, frames, (int)animation->channels.size(),
+         list_words);
+  printf("%d pikmin for %d ticks\n", options.pikmin, options.ticks);
+  printf("%-26s %10s %10s %10s %12s\n", "Per draw", "Patches", "Words",
+         "Runs", "ns");
+  Report("Interpreted", interpreted);
+  Report("Compiled", compiled);
+  Report("Compiled, grouped", grouped);
+  printf("Mismatched ticks: %d\n", mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
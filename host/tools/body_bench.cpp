@@ -0,0 +1,456 @@
+// Compares the per-tick body loops of physics::World -- MoveBodies,
+// BodiesOverlap and CollideBodiesWithLevel -- over the body layout from
+// before the hot / cold split and the one World uses now. The old layout is
+// rebuilt here field for field, with pointers stood in by u32s so that it is
+// sized the way it is on the DS.
+//
+// Each layout runs the same seeded crowd of bodies twice: once timed, and once
+// through a model of the ARM946E-S data cache (4 KB, 4 way set associative,
+// 32 byte lines, round robin replacement) that counts the lines each loop
+// misses on.
+//
+// Usage: body_bench [--bodies=N] [--ticks=N] [--seed=N]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nds.h>
+
+#include "numeric_types.h"
+#include "physics/body.h"
+#include "project_settings.h"
+#include "vector.h"
+
+using numeric_types::fixed;
+using numeric_types::literals::operator"" _f;
+
+namespace {
+
+// Our own generator, so runs match across C libraries.
+class Random {
+  public:
+    explicit Random(u32 seed) : state_{seed ? seed : 1} {}
+    u32 Next() {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_;
+    }
+    // Uniform in [low, high)
+    fixed Range(fixed low, fixed high) {
+      return low + fixed::FromRaw(Next() % (u32)(high - low).data_);
+    }
+  private:
+    u32 state_;
+};
+
+struct Options {
+  int bodies = MAX_PHYSICS_BODIES;
+  int ticks = 1000;
+  u32 seed = 1;
+};
+
+bool ParseOption(const char* arg, const char* name, std::string& value) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 and arg[length] == '=') {
+    value = arg + length + 1;
+    return true;
+  }
+  return false;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseOption(argv[i], "--bodies", value)) {
+      options.bodies = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--ticks", value)) {
+      options.ticks = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--seed", value)) {
+      options.seed = strtoul(value.c_str(), nullptr, 10);
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  if (options.bodies < 1 or options.bodies > MAX_PHYSICS_BODIES) {
+    fprintf(stderr, "--bodies must be between 1 and %d\n", MAX_PHYSICS_BODIES);
+    return false;
+  }
+  return true;
+}
+
+// physics::Body as it was before the split.
+struct LegacyCollisionResult {
+  u32 body;
+  u32 collision_group;
+};
+
+struct LegacyBody {
+  Handle handle;
+  Vec3 position;
+  Vec3 velocity;
+  Vec3 acceleration;
+  Vec2 xz_position;
+  fixed height;
+  fixed radius;
+  Handle owner;
+  u32 collision_group;
+  u32 sensor_groups;
+  u32 result_groups;
+  u32 num_results;
+  LegacyCollisionResult collision_results[8];
+  // The bitfield flags; only gravity and level collision matter here.
+  u16 flags;
+  u16 generation;
+  Vec3 old_position;
+  fixed old_radius;
+};
+
+const u16 kLegacyGravity = 0x1;
+const u16 kLegacyCollidesWithLevel = 0x2;
+
+struct LegacyLayout {
+  static const char* Name() { return "Before (one Body struct)"; }
+
+  LegacyBody bodies[MAX_PHYSICS_BODIES] __attribute__((aligned(32)));
+
+  void Init(int id, Vec3 position, fixed radius, fixed height) {
+    LegacyBody& body = bodies[id];
+    body = LegacyBody{};
+    body.position = position;
+    body.radius = radius;
+    body.height = height;
+    body.flags = kLegacyGravity | kLegacyCollidesWithLevel;
+  }
+  Vec3& Position(int id) { return bodies[id].position; }
+  Vec3& Velocity(int id) { return bodies[id].velocity; }
+  Vec3& Acceleration(int id) { return bodies[id].acceleration; }
+  fixed& Radius(int id) { return bodies[id].radius; }
+  fixed& Height(int id) { return bodies[id].height; }
+  Vec3& OldPosition(int id) { return bodies[id].old_position; }
+  const void* Flags(int id) { return &bodies[id].flags; }
+  bool Gravity(int id) { return bodies[id].flags & kLegacyGravity; }
+  bool CollidesWithLevel(int id) {
+    return bodies[id].flags & kLegacyCollidesWithLevel;
+  }
+  size_t Bytes() { return sizeof(bodies); }
+};
+
+struct SplitLayout {
+  static const char* Name() { return "After (hot / cold split)"; }
+
+  physics::Body bodies[MAX_PHYSICS_BODIES] __attribute__((aligned(32)));
+  physics::BodyColdData cold[MAX_PHYSICS_BODIES] __attribute__((aligned(32)));
+  Vec3 old_position[MAX_PHYSICS_BODIES] __attribute__((aligned(32)));
+
+  void Init(int id, Vec3 position, fixed radius, fixed height) {
+    physics::Body& body = bodies[id];
+    body = physics::Body{};
+    body.position = position;
+    body.radius = radius;
+    body.height = height;
+    body.affected_by_gravity = 1;
+    body.collides_with_level = 1;
+    cold[id] = physics::BodyColdData{};
+  }
+  Vec3& Position(int id) { return bodies[id].position; }
+  Vec3& Velocity(int id) { return bodies[id].velocity; }
+  Vec3& Acceleration(int id) { return bodies[id].acceleration; }
+  fixed& Radius(int id) { return bodies[id].radius; }
+  fixed& Height(int id) { return bodies[id].height; }
+  Vec3& OldPosition(int id) { return old_position[id]; }
+  // Bitfields have no address; their storage starts right after the masks.
+  const void* Flags(int id) { return &bodies[id].sensor_groups + 1; }
+  bool Gravity(int id) { return bodies[id].affected_by_gravity; }
+  bool CollidesWithLevel(int id) { return bodies[id].collides_with_level; }
+  size_t Bytes() {
+    return sizeof(bodies) + sizeof(cold) + sizeof(old_position);
+  }
+};
+
+// Stands in for the cache model on timed runs.
+struct NoCache {
+  void Touch(const void*, size_t) {}
+};
+
+class DataCache {
+  public:
+    void Touch(const void* address, size_t size) {
+      const uintptr_t first = (uintptr_t)address / kLineSize;
+      const uintptr_t last = ((uintptr_t)address + size - 1) / kLineSize;
+      for (uintptr_t line = first; line <= last; line++) {
+        Access(line);
+      }
+    }
+    u64 accesses = 0;
+    u64 misses = 0;
+  private:
+    static const int kLineSize = 32;
+    static const int kWays = 4;
+    static const int kSets = 4096 / kLineSize / kWays;
+
+    void Access(uintptr_t line) {
+      accesses++;
+      Set& set = sets_[line % kSets];
+      for (int way = 0; way < kWays; way++) {
+        if (set.valid[way] and set.tag[way] == line) {
+          return;
+        }
+      }
+      misses++;
+      set.tag[set.next] = line;
+      set.valid[set.next] = true;
+      set.next = (set.next + 1) % kWays;
+    }
+
+    struct Set {
+      uintptr_t tag[kWays] = {};
+      bool valid[kWays] = {};
+      int next = 0;
+    };
+    Set sets_[kSets];
+};
+
+struct Scene {
+  std::vector<Vec3> positions;
+  std::vector<fixed> radii;
+  // Pairs of bodies the broadphase would hand to BodiesOverlap, in roughly
+  // the order its buckets come out in: grouped by cell, not by id.
+  std::vector<std::pair<int, int>> pairs;
+  // A flat 64x64 height map, read by the level collision loop
+  std::vector<u8> heights;
+};
+
+Scene BuildScene(const Options& options) {
+  Scene scene;
+  Random random(options.seed);
+  for (int i = 0; i < options.bodies; i++) {
+    scene.positions.push_back(
+        Vec3{random.Range(0_f, 64_f), 0_f, random.Range(0_f, 64_f)});
+    scene.radii.push_back(i % 8 == 0 ? random.Range(1_f, 4_f) : 1_f);
+  }
+  std::vector<std::pair<int, std::pair<int, int>>> cell_pairs;
+  for (int a = 0; a < options.bodies; a++) {
+    for (int b = a + 1; b < options.bodies; b++) {
+      Vec3 difference = scene.positions[a] - scene.positions[b];
+      difference.y = 0_f;
+      const fixed reach = scene.radii[a] + scene.radii[b] + 2_f;
+      if (difference.Length2() < reach * reach) {
+        const int cell = ((int)scene.positions[a].z >> 2) * 16 +
+                         ((int)scene.positions[a].x >> 2);
+        cell_pairs.push_back({cell, {a, b}});
+      }
+    }
+  }
+  std::stable_sort(cell_pairs.begin(), cell_pairs.end(),
+      [](const std::pair<int, std::pair<int, int>>& a,
+         const std::pair<int, std::pair<int, int>>& b) {
+        return a.first < b.first;
+      });
+  for (auto& entry : cell_pairs) {
+    scene.pairs.push_back(entry.second);
+  }
+  scene.heights.resize(64 * 64);
+  for (u8& height : scene.heights) {
+    height = random.Next() % 8;
+  }
+  return scene;
+}
+
+template <typename Layout, typename Cache>
+void MoveBodies(Layout& layout, int count, Cache& cache) {
+  for (int id = 0; id < count; id++) {
+    Vec3& position = layout.Position(id);
+    Vec3& velocity = layout.Velocity(id);
+    cache.Touch(layout.Flags(id), 2);
+    cache.Touch(&position, sizeof(Vec3));
+    cache.Touch(&velocity, sizeof(Vec3));
+    cache.Touch(&layout.Acceleration(id), sizeof(Vec3));
+    cache.Touch(&layout.OldPosition(id), sizeof(Vec3));
+    layout.OldPosition(id) = position;
+    position += velocity;
+    velocity += layout.Acceleration(id);
+    if (layout.Gravity(id)) {
+      velocity.y -= GRAVITY_CONSTANT;
+    }
+  }
+}
+
+template <typename Layout, typename Cache>
+int BodiesOverlap(Layout& layout, const Scene& scene, Cache& cache) {
+  int overlapping = 0;
+  for (auto& pair : scene.pairs) {
+    const int a = pair.first;
+    const int b = pair.second;
+    cache.Touch(&layout.Position(a), sizeof(Vec3));
+    cache.Touch(&layout.Height(a), 2 * sizeof(fixed));
+    cache.Touch(&layout.Position(b), sizeof(Vec3));
+    cache.Touch(&layout.Height(b), 2 * sizeof(fixed));
+    const Vec3& pa = layout.Position(a);
+    const Vec3& pb = layout.Position(b);
+    const fixed dx = pa.x - pb.x;
+    const fixed dz = pa.z - pb.z;
+    const fixed sum = layout.Radius(a) + layout.Radius(b);
+    if (dx * dx + dz * dz < sum * sum and
+        pa.y + layout.Height(a) >= pb.y and pb.y + layout.Height(b) >= pa.y) {
+      overlapping++;
+    }
+  }
+  return overlapping;
+}
+
+template <typename Layout, typename Cache>
+void CollideBodiesWithLevel(Layout& layout, int count, const Scene& scene,
+    Cache& cache) {
+  for (int id = 0; id < count; id++) {
+    cache.Touch(layout.Flags(id), 2);
+    if (not layout.CollidesWithLevel(id)) {
+      continue;
+    }
+    Vec3& position = layout.Position(id);
+    cache.Touch(&position, sizeof(Vec3));
+    cache.Touch(&layout.OldPosition(id), sizeof(Vec3));
+    const int x = (int)position.x & 63;
+    const int z = (int)position.z & 63;
+    const u8* height = &scene.heights[z * 64 + x];
+    cache.Touch(height, 1);
+    const fixed ground = fixed::FromInt(*height);
+    if (position.y < ground) {
+      cache.Touch(&layout.Velocity(id), sizeof(Vec3));
+      position.y = ground;
+      layout.Velocity(id).y = 0_f;
+    }
+  }
+}
+
+// Keeps the crowd milling about, so positions keep changing between ticks.
+template <typename Layout>
+void Steer(Layout& layout, int count, int tick) {
+  for (int id = 0; id < count; id++) {
+    Vec3& velocity = layout.Velocity(id);
+    const bool flip = ((id + tick) & 63) == 0;
+    velocity.x = flip ? 0_f - velocity.x : (id & 1 ? 0.125_f : -0.125_f);
+    velocity.z = flip ? 0_f - velocity.z : (id & 2 ? 0.125_f : -0.125_f);
+  }
+}
+
+struct Phase {
+  u64 cycles = 0;
+  u64 accesses = 0;
+  u64 misses = 0;
+};
+
+struct Results {
+  Phase move;
+  Phase overlap;
+  Phase level;
+  size_t bytes = 0;
+  int overlapping = 0;
+};
+
+template <typename Layout>
+void Reset(Layout& layout, const Scene& scene, int count) {
+  for (int id = 0; id < count; id++) {
+    layout.Init(id, scene.positions[id], scene.radii[id], 2_f);
+  }
+}
+
+template <typename Layout>
+Results Run(const Options& options, const Scene& scene) {
+  // Static, so the arrays keep their cache line alignment.
+  static Layout storage;
+  Layout* layout = &storage;
+  Results results;
+  results.bytes = layout->Bytes();
+  const int count = options.bodies;
+
+  NoCache none;
+  Reset(*layout, scene, count);
+  cpuStartTiming(0);
+  for (int tick = 0; tick < options.ticks; tick++) {
+    Steer(*layout, count, tick);
+    u32 start = cpuGetTiming();
+    MoveBodies(*layout, count, none);
+    u32 end = cpuGetTiming();
+    results.move.cycles += end - start;
+    start = end;
+    results.overlapping += BodiesOverlap(*layout, scene, none);
+    end = cpuGetTiming();
+    results.overlap.cycles += end - start;
+    start = end;
+    CollideBodiesWithLevel(*layout, count, scene, none);
+    end = cpuGetTiming();
+    results.level.cycles += end - start;
+  }
+
+  // Counted from the second tick on, once the cache has filled up.
+  DataCache cache;
+  Reset(*layout, scene, count);
+  for (int tick = 0; tick <= options.ticks; tick++) {
+    Steer(*layout, count, tick);
+    for (Phase* phase : {&results.move, &results.overlap, &results.level}) {
+      const u64 accesses = cache.accesses;
+      const u64 misses = cache.misses;
+      if (phase == &results.move) {
+        MoveBodies(*layout, count, cache);
+      } else if (phase == &results.overlap) {
+        BodiesOverlap(*layout, scene, cache);
+      } else {
+        CollideBodiesWithLevel(*layout, count, scene, cache);
+      }
+      if (tick > 0) {
+        phase->accesses += cache.accesses - accesses;
+        phase->misses += cache.misses - misses;
+      }
+    }
+  }
+
+  return results;
+}
+
+void Report(const char* name, const Results& results, int ticks) {
+  printf("%s: %u bytes\n", name, (unsigned)results.bytes);
+  printf("  %-26s %12s %12s %12s\n", "Per tick", "Cycles", "Lines read",
+         "Misses");
+  const double t = ticks ? (double)ticks : 1.0;
+  const char* names[] = {"MoveBodies", "BodiesOverlap",
+                         "CollideBodiesWithLevel"};
+  const Phase* phases[] = {&results.move, &results.overlap, &results.level};
+  for (int i = 0; i < 3; i++) {
+    printf("  %-26s %12.0f %12.0f %12.0f\n", names[i], phases[i]->cycles / t,
+           phases[i]->accesses / t, phases[i]->misses / t);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  const Scene scene = BuildScene(options);
+  printf("%d bodies, %d pairs, %d ticks, seed %u\n", options.bodies,
+         (int)scene.pairs.size(), options.ticks, options.seed);
+  printf("Body: %u bytes before, %u bytes hot after\n",
+         (unsigned)sizeof(LegacyBody), (unsigned)sizeof(physics::Body));
+
+  const Results before = Run<LegacyLayout>(options, scene);
+  const Results after = Run<SplitLayout>(options, scene);
+  Report(LegacyLayout::Name(), before, options.ticks);
+  Report(SplitLayout::Name(), after, options.ticks);
+
+  // Both layouts have to have done the same work.
+  if (before.overlapping != after.overlapping) {
+    fprintf(stderr, "Layouts disagree: %d overlaps before, %d after\n",
+            before.overlapping, after.overlapping);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+// Drives render::PolygonBudget against a simulated geometry engine, to check
+// that the budget settles close to the hardware limit without overflowing.
+// Each simulated mesh really draws some seeded fraction of its exporter
+// draw_cost, and the polygon and vertex RAM counters saturate just like the
+// real ones do. The scene grows from a handful of entities to a crowd and back
+// down again, so the budget has to follow it both ways.
+//
+// Usage: budget_sim [--frames=N] [--seed=N] [--fixed]
+//
+// --fixed never reports anything back to the budget, which shows how the old
+// static MAX_POLYGONS_PER_PASS budget did on the same scene.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nds.h>
+
+#include "dsgx.h"
+#include "project_settings.h"
+#include "render/polygon_budget.h"
+
+using render::PolygonBudget;
+
+namespace {
+
+// Our own generator, so runs match across C libraries.
+class Random {
+  public:
+    explicit Random(u32 seed) : state_{seed ? seed : 1} {}
+    u32 Next() {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_;
+    }
+    // Uniform in [low, high)
+    int Range(int low, int high) {
+      return low + (int)(Next() % (u32)(high - low));
+    }
+  private:
+    u32 state_;
+};
+
+struct SimulatedMesh {
+  Mesh mesh;
+  // Percent of draw_cost that survives culling, and vertices per 100 polygons.
+  int visible_percent;
+  int vertices_per_100;
+};
+
+struct Options {
+  int frames = 3000;
+  u32 seed = 1;
+  bool fixed = false;
+};
+
+bool ParseOption(const char* arg, const char* name, std::string& value) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 and arg[length] == '=') {
+    value = arg + length + 1;
+    return true;
+  }
+  return false;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseOption(argv[i], "--frames", value)) {
+      options.frames = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--seed", value)) {
+      options.seed = strtoul(value.c_str(), nullptr, 10);
+    } else if (strcmp(argv[i], "--fixed") == 0) {
+      options.fixed = true;
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// How many entities are in view on this frame: a few, then a crowd, then a
+// few again.
+int EntitiesInView(int frame, int frames) {
+  const int third = frames / 3 ? frames / 3 : 1;
+  if (frame < third) {
+    return 12;
+  }
+  if (frame < 2 * third) {
+    return 150;
+  }
+  return 40;
+}
+
+struct Totals {
+  int passes = 0;
+  int frames = 0;
+  s64 polygons = 0;
+  int overflows = 0;
+  int budget_low = 0x7FFFFFFF;
+  int budget_high = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  Random random(options.seed);
+  std::vector<SimulatedMesh> meshes;
+  const int kDrawCosts[] = {60, 80, 120, 300, 800, 1500};
+  for (int draw_cost : kDrawCosts) {
+    SimulatedMesh simulated;
+    simulated.mesh.draw_cost = draw_cost;
+    simulated.visible_percent = random.Range(35, 65);
+    simulated.vertices_per_100 = random.Range(150, 320);
+    meshes.push_back(simulated);
+  }
+  // Mostly pikmin, plus the odd bigger thing.
+  std::vector<int> scene;
+  for (int i = 0; i < 150; i++) {
+    scene.push_back(i % 10 == 0 ? random.Range(2, 6) : random.Range(0, 2));
+  }
+
+  PolygonBudget budget;
+  Totals phases[3];
+  const int third = options.frames / 3 ? options.frames / 3 : 1;
+
+  for (int frame = 0; frame < options.frames; frame++) {
+    Totals& totals = phases[frame / third < 3 ? frame / third : 2];
+    totals.frames++;
+    const int count = EntitiesInView(frame, options.frames);
+    int next = 0;
+    while (next < count) {
+      budget.StartPass();
+      int estimate = 0;
+      int polygons = random.Range(0, 60);  // Particles and the rear plane
+      int vertices = polygons * 3;
+      // Greedy, like the planner without the overlaps.
+      do {
+        SimulatedMesh& simulated = meshes[scene[next++]];
+        const int drawn = (int)simulated.mesh.draw_cost *
+            random.Range(simulated.visible_percent - 8,
+                         simulated.visible_percent + 1) / 100;
+        if (not options.fixed and budget.WantsSample(simulated.mesh)) {
+          budget.Sample(simulated.mesh, drawn);
+        }
+        estimate += budget.Cost(simulated.mesh);
+        budget.Drawn(simulated.mesh);
+        polygons += drawn;
+        vertices += drawn * simulated.vertices_per_100 / 100;
+      } while (next < count and
+               estimate + budget.Cost(meshes[scene[next]].mesh) <=
+                   budget.PassBudget());
+
+      // The hardware counters stop at their limits.
+      if (polygons >= PolygonBudget::kPolygonCapacity or
+          vertices >= PolygonBudget::kVertexCapacity) {
+        totals.overflows++;
+      }
+      if (polygons > PolygonBudget::kPolygonCapacity) {
+        polygons = PolygonBudget::kPolygonCapacity;
+      }
+      if (vertices > PolygonBudget::kVertexCapacity) {
+        vertices = PolygonBudget::kVertexCapacity;
+      }
+      if (not options.fixed) {
+        budget.EndPass(polygons, vertices);
+      }
+
+      totals.passes++;
+      totals.polygons += polygons;
+      if (budget.PassBudget() < totals.budget_low) {
+        totals.budget_low = budget.PassBudget();
+      }
+      if (budget.PassBudget() > totals.budget_high) {
+        totals.budget_high = budget.PassBudget();
+      }
+    }
+  }
+
+  printf("%d frames, seed %u, %s budget\n", options.frames, options.seed,
+         options.fixed ? "fixed" : "measured");
+  printf("%-10s %10s %12s %10s %14s\n", "Entities", "Passes/fr", "Polys/pass",
+         "Overflows", "Budget range");
+  for (int phase = 0; phase < 3; phase++) {
+    const Totals& totals = phases[phase];
+    if (totals.passes == 0) {
+      continue;
+    }
+    char range[32];
+    snprintf(range, sizeof(range), "%d-%d", totals.budget_low,
+             totals.budget_high);
+    printf("%-10d %10.2f %12.1f %10d %14s\n",
+           EntitiesInView(phase * third, options.frames),
+           (double)totals.passes / totals.frames,
+           (double)totals.polygons / totals.passes, totals.overflows, range);
+  }
+  printf("Mesh costs:\n");
+  for (auto& simulated : meshes) {
+    printf("  draw_cost %4u  measured %4u  true ~%d\n",
+           simulated.mesh.draw_cost, simulated.mesh.measured_cost,
+           (int)simulated.mesh.draw_cost * (simulated.visible_percent - 4) / 100);
+  }
+  return 0;
+}
@@ -0,0 +1,242 @@
+// Checks the renderer's fixed point camera matrices (render/camera_matrix.h)
+// against the same matrices worked out in doubles, the way gluLookAt and the
+// old float ClipFriendlyPerspective built them. Cameras are seeded at random
+// around a level sized area, looking down at it from near and far, with a
+// range of fields of view, screen windows and depth ranges.
+//
+// Usage: camera_check [--cameras=N] [--seed=N]
+//
+// Prints the largest error found in each part of the matrices, and exits
+// non-zero if any is past its tolerance.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <nds.h>
+
+#include "numeric_types.h"
+#include "render/camera_matrix.h"
+#include "render/frustum.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+using numeric_types::Brads;
+using render::ScreenWindow;
+
+namespace {
+
+// Our own generator, so runs match across C libraries.
+class Random {
+  public:
+    explicit Random(u32 seed) : state_{seed ? seed : 1} {}
+    u32 Next() {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_;
+    }
+    // Uniform in [low, high), in steps of 1/16
+    double Range(double low, double high) {
+      const int steps = (int)((high - low) * 16);
+      return low + (Next() % (u32)steps) / 16.0;
+    }
+  private:
+    u32 state_;
+};
+
+struct Options {
+  int cameras = 10000;
+  u32 seed = 1;
+};
+
+bool ParseOption(const char* arg, const char* name, std::string& value) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 and arg[length] == '=') {
+    value = arg + length + 1;
+    return true;
+  }
+  return false;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseOption(argv[i], "--cameras", value)) {
+      options.cameras = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--seed", value)) {
+      options.seed = strtoul(value.c_str(), nullptr, 10);
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Vector {
+  double x, y, z;
+};
+
+Vector Normalize(Vector v) {
+  const double length = sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+  return Vector{v.x / length, v.y / length, v.z / length};
+}
+
+Vector Cross(Vector a, Vector b) {
+  return Vector{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x};
+}
+
+double Dot(Vector a, Vector b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// gluLookAt with Y up, in MATRIX_LOAD4x4 order.
+void ReferenceLookAt(Vector eye, Vector subject, double (&matrix)[16]) {
+  const Vector forward = Normalize(
+      Vector{subject.x - eye.x, subject.y - eye.y, subject.z - eye.z});
+  const Vector side = Normalize(Cross(forward, Vector{0, 1, 0}));
+  const Vector up = Cross(side, forward);
+  const double view[16] = {
+    side.x, up.x, -forward.x, 0,
+    side.y, up.y, -forward.y, 0,
+    side.z, up.z, -forward.z, 0,
+    -Dot(eye, side), -Dot(eye, up), Dot(eye, forward), 1};
+  memcpy(matrix, view, sizeof(view));
+}
+
+void ReferencePerspective(double near, double far, double fov,
+    double left, double right, double bottom, double top,
+    double (&matrix)[16]) {
+  const double cotangent = cos(fov) / sin(fov);
+  const double scale_x = 2 / (right - left);
+  const double scale_y = 2 / (top - bottom);
+  const double projection[16] = {
+    0.75 * cotangent * scale_x, 0, 0, 0,
+    0, cotangent * scale_y, 0, 0,
+    (right + left) / 2 * scale_x, (top + bottom) / 2 * scale_y,
+        -(far + near) / (far - near), -1,
+    0, 0, -2 * far * near / (far - near), 0};
+  memcpy(matrix, projection, sizeof(projection));
+}
+
+double ToDouble(int32 value) {
+  return value / 4096.0;
+}
+
+double ToDouble(fixed value) {
+  return ToDouble(value.data_);
+}
+
+fixed ToFixed(double value) {
+  return fixed::FromRaw((s32)lround(value * 4096));
+}
+
+Vec3 ToVec3(Vector v) {
+  return Vec3{ToFixed(v.x), ToFixed(v.y), ToFixed(v.z)};
+}
+
+struct Error {
+  const char* name;
+  // Past this, the check fails.
+  double tolerance;
+  double worst;
+};
+
+void Measure(Error& error, double actual, double expected, double scale) {
+  const double difference = fabs(actual - expected) / scale;
+  if (difference > error.worst) {
+    error.worst = difference;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  // Rotation is within a unit basis; translation is relative to how far the
+  // camera is from the origin, and projection terms to their own size.
+  Error rotation{"View rotation", 1.0 / 256};
+  Error translation{"View translation (relative)", 1.0 / 256};
+  Error projection{"Projection (relative)", 1.0 / 256};
+
+  // The screen windows the strategies draw with.
+  const ScreenWindow kFull{};
+  const ScreenWindow kTop{-1.0_f, 1.0_f, 0_f, 1.0_f};
+  const ScreenWindow kLeft{-1.0_f, 0_f, -1.0_f, 1.0_f};
+  const ScreenWindow kCorner{0.5_f, 1.0_f, -1.0_f, -0.5_f};
+  const ScreenWindow kWindows[] = {kFull, kTop, kLeft, kCorner};
+
+  Random random(options.seed);
+  for (int i = 0; i < options.cameras; i++) {
+    const Vector subject{random.Range(0, 128), random.Range(0, 8),
+                         random.Range(-128, 0)};
+    const double angle = random.Range(0, 2 * M_PI);
+    const double distance = random.Range(1, 64);
+    const double height = random.Range(0.5, 48);
+    const Vector eye{subject.x + cos(angle) * distance, subject.y + height,
+                     subject.z + sin(angle) * distance};
+    // Snap to what fixed point can represent, so both sides start equal.
+    const Vec3 fixed_eye = ToVec3(eye);
+    const Vec3 fixed_subject = ToVec3(subject);
+    const Vector snapped_eye{ToDouble(fixed_eye.x), ToDouble(fixed_eye.y),
+                             ToDouble(fixed_eye.z)};
+    const Vector snapped_subject{ToDouble(fixed_subject.x),
+        ToDouble(fixed_subject.y), ToDouble(fixed_subject.z)};
+
+    const Brads fov = Brads::Raw(
+        degreesToAngle(20 + (int)(random.Next() % 40)));
+    const double far = i % 3 == 0 ? 256 : random.Range(1, 768);
+    const double near = 0.1;
+    const ScreenWindow& window = kWindows[i % 4];
+
+    render::Frustum frustum;
+    frustum.Set(fixed_eye, fixed_subject, fov, ToFixed(near), ToFixed(far),
+        window);
+    const m4x4 view = render::LookAtMatrix(frustum);
+    m4x4 perspective = render::PerspectiveMatrix(ToFixed(near), 256.0_f, fov,
+        window);
+    // Passes move the depth range after the fact.
+    render::SetDepthRange(perspective, ToFixed(near), ToFixed(far));
+
+    double expected_view[16];
+    ReferenceLookAt(snapped_eye, snapped_subject, expected_view);
+    double expected_perspective[16];
+    ReferencePerspective(ToDouble(ToFixed(near)), ToDouble(ToFixed(far)),
+        fov.data_ * 2 * M_PI / DEGREES_IN_CIRCLE,
+        ToDouble(window.left), ToDouble(window.right), ToDouble(window.bottom),
+        ToDouble(window.top), expected_perspective);
+
+    const double reach = std::max(1.0, sqrt(Dot(snapped_eye, snapped_eye)));
+    for (int e = 0; e < 16; e++) {
+      if (e >= 12) {
+        Measure(translation, ToDouble(view.m[e]), expected_view[e], reach);
+      } else {
+        Measure(rotation, ToDouble(view.m[e]), expected_view[e], 1);
+      }
+      Measure(projection, ToDouble(perspective.m[e]), expected_perspective[e],
+          std::max(1.0, fabs(expected_perspective[e])));
+    }
+  }
+
+  printf("%d cameras\n", options.cameras);
+  printf("%-30s %12s %12s\n", "Part", "Worst", "Tolerance");
+  bool passed = true;
+  for (const Error* error : {&rotation, &translation, &projection}) {
+    printf("%-30s %12.6f %12.6f\n", error->name, error->worst,
+           error->tolerance);
+    if (error->worst > error->tolerance) {
+      passed = false;
+    }
+  }
+  printf(passed ? "Within tolerance\n" : "Out of tolerance\n");
+  return passed ? 0 : 1;
+}
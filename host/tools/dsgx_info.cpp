@@ -0,0 +1,163 @@
+// Loads a .dsgx file the same way the game does, prints what's inside its
+// default mesh, and times ApplyAnimation across every frame of every
+// animation. Handy for checking exporter output without a flashcart.
+//
+// It also bakes the animations (see Dsgx::BakeAnimations) every --bake-step
+// frames, checks that each baked display list matches what patching produces,
+// and reports what baking would cost in memory against the patching time it
+// saves on every draw, to help decide which actors are worth it.
+//
+// Usage: dsgx_info [--repeat=N] [--bake-step=N] file.dsgx
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nds.h>
+
+#include "dsgx.h"
+#include "dsgx_allocator.h"
+#include "load_file.h"
+#include "project_settings.h"
+
+namespace {
+
+// Words ApplyAnimation writes for each frame.
+u32 PatchedWords(const Animation& animation) {
+  u32 words = 0;
+  for (auto& channel : animation.channels) {
+    for (auto& offset_list : channel.first.offset_lists) {
+      words += offset_list.num_offsets * channel.second.word_count;
+    }
+  }
+  return words;
+}
+
+// Baked lists that differ from patching the same frame into model_data.
+int BakeMismatches(Dsgx& dsgx, Animation* animation, Mesh* mesh) {
+  int mismatches = 0;
+  for (u32 frame = 0; frame < animation->frame_length;
+       frame += animation->baked_step) {
+    dsgx.ApplyAnimation(animation, frame, mesh);
+    const u32* baked = animation->BakedList(frame);
+    if (memcmp(baked, mesh->model_data,
+               animation->baked_list_words * sizeof(u32)) != 0) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int repeat = 100;
+  u32 bake_step = 1;
+  const char* filename = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--repeat=", 9) == 0) {
+      repeat = atoi(argv[i] + 9);
+    } else if (strncmp(argv[i], "--bake-step=", 12) == 0) {
+      bake_step = strtoul(argv[i] + 12, nullptr, 10);
+    } else if (filename == nullptr) {
+      filename = argv[i];
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (filename == nullptr) {
+    fprintf(stderr, "Usage: %s [--repeat=N] [--bake-step=N] file.dsgx\n",
+            argv[0]);
+    return 1;
+  }
+  if (bake_step == 0) {
+    bake_step = 1;
+  }
+
+  u32 length = 0;
+  std::vector<u32> data = tools::LoadFile(filename, length);
+  if (data.empty()) {
+    fprintf(stderr, "Couldn't load %s\n", filename);
+    return 1;
+  }
+
+  // Dsgx keeps pointers into the data it was given, so it has to outlive it.
+  Dsgx dsgx(data.data(), length);
+  Mesh* mesh = dsgx.DefaultMesh();
+
+  printf("Mesh: %s\n", mesh->name);
+  printf("Bounding radius: %.3f\n", (double)mesh->bounding_radius.data_ / 4096.0);
+  printf("Draw cost: %u\n", mesh->draw_cost);
+  printf("LODs: %u\n", mesh->lod_count);
+  for (u32 i = 0; i < mesh->lod_count; i++) {
+    printf("  %s (draw cost %u)\n", mesh->lods[i]->name, mesh->lods[i]->draw_cost);
+  }
+  printf("Bones: %d\n", (int)mesh->bones.size());
+  printf("Textures: %d\n", (int)mesh->textures.size());
+  for (auto& texture : mesh->textures) {
+    printf("  %s (%u offsets)\n", texture.name, texture.num_offsets);
+  }
+
+  printf("Animations: %d\n", (int)mesh->animations.size());
+  printf("%-24s %8s %8s %8s %12s\n", "Name", "Frames", "Channels", "Words",
+         "ns / frame");
+  std::vector<double> patch_times;
+  for (auto& entry : mesh->animations) {
+    Animation* animation = dsgx.GetAnimation(entry.first, mesh);
+    const u32 frames = animation->frame_length;
+    double per_frame = 0.0;
+    if (frames > 0 and repeat > 0) {
+      auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < repeat; r++) {
+        for (u32 frame = 0; frame < frames; frame++) {
+          dsgx.ApplyAnimation(animation, frame, mesh);
+        }
+      }
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      per_frame = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+          elapsed).count() / ((double)frames * repeat);
+    }
+    printf("%-24s %8u %8d %8u %12.1f\n", entry.first.c_str(), frames,
+           (int)animation->channels.size(), PatchedWords(*animation),
+           per_frame);
+    patch_times.push_back(per_frame);
+  }
+
+  // Every mesh in the file is baked, as the game would; the table shows the
+  // default mesh's share.
+  DsgxAllocator allocator;
+  const u32 baked_bytes = dsgx.BakeAnimations(&allocator, bake_step);
+  printf("Baked every %u frame(s), %u words per list:\n", bake_step,
+         mesh->model_data[0] + 1);
+  printf("%-24s %8s %10s %12s %10s\n", "Name", "Lists", "Bytes",
+         "Saves ns", "Mismatch");
+  int index = 0;
+  for (auto& entry : mesh->animations) {
+    Animation* animation = &entry.second;
+    if (animation->baked_lists == nullptr) {
+      printf("%-24s %8s\n", entry.first.c_str(), "no room");
+      index++;
+      continue;
+    }
+    const u32 lists = (animation->frame_length + bake_step - 1) / bake_step;
+    printf("%-24s %8u %10u %12.1f %10d\n", entry.first.c_str(), lists,
+           lists * animation->baked_list_words * (u32)sizeof(u32),
+           patch_times[index], BakeMismatches(dsgx, animation, mesh));
+    index++;
+  }
+  printf("Whole actor: %u bytes baked, of %u in the actor pool\n", baked_bytes,
+         DsgxAllocator::kPoolSize);
+
+  // The game picks the finest of these that fits in what the pool has left
+  // after loading every actor, starting from BAKED_ANIMATION_STEP.
+  printf("File: %u bytes. Whole actor baked every:\n", length);
+  for (u32 step = 1; step <= MAX_BAKED_ANIMATION_STEP; step *= 2) {
+    printf("  %2u frame(s): %8u bytes\n", step, dsgx.BakedBytes(step));
+  }
+
+  return 0;
+}
@@ -0,0 +1,262 @@
+// Checks render::Frustum::TestSphere, which the renderer culls and depth sorts
+// every entity with, against the same test worked out in doubles from the
+// gluLookAt basis and the edges of the projection. Cameras are seeded the way
+// camera_check seeds them, and each one is handed a batch of spheres scattered
+// around what it's looking at, many of them straddling an edge.
+//
+// Usage: frustum_check [--cameras=N] [--spheres=N] [--seed=N]
+//
+// Fixed point can't agree with doubles right at an edge, so a sphere only
+// counts as misjudged if it's further inside or outside than the tolerance.
+// Prints the worst case of each kind, and exits non-zero if any is past its
+// tolerance.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <nds.h>
+
+#include "numeric_types.h"
+#include "render/frustum.h"
+
+using numeric_types::literals::operator"" _f;
+using numeric_types::fixed;
+using numeric_types::Brads;
+using render::ScreenWindow;
+
+namespace {
+
+// Our own generator, so runs match across C libraries.
+class Random {
+  public:
+    explicit Random(u32 seed) : state_{seed ? seed : 1} {}
+    u32 Next() {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_;
+    }
+    // Uniform in [low, high), in steps of 1/16
+    double Range(double low, double high) {
+      const int steps = (int)((high - low) * 16);
+      return low + (Next() % (u32)steps) / 16.0;
+    }
+  private:
+    u32 state_;
+};
+
+struct Options {
+  int cameras = 10000;
+  int spheres = 64;
+  u32 seed = 1;
+};
+
+bool ParseOption(const char* arg, const char* name, std::string& value) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 and arg[length] == '=') {
+    value = arg + length + 1;
+    return true;
+  }
+  return false;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseOption(argv[i], "--cameras", value)) {
+      options.cameras = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--spheres", value)) {
+      options.spheres = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--seed", value)) {
+      options.seed = strtoul(value.c_str(), nullptr, 10);
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Vector {
+  double x, y, z;
+};
+
+Vector Normalize(Vector v) {
+  const double length = sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+  return Vector{v.x / length, v.y / length, v.z / length};
+}
+
+Vector Cross(Vector a, Vector b) {
+  return Vector{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+                a.x * b.y - a.y * b.x};
+}
+
+double Dot(Vector a, Vector b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// The frustum in doubles: the gluLookAt basis, plus how far the projection
+// lets a point stray sideways and up for each unit in front of the camera.
+struct ReferenceFrustum {
+  Vector eye;
+  Vector side;
+  Vector up;
+  Vector forward;
+  double near;
+  double far;
+  double left, right, bottom, top;
+
+  ReferenceFrustum(Vector eye, Vector subject, double fov, double near,
+      double far, const double (&window)[4])
+      : eye{eye}, near{near}, far{far} {
+    forward = Normalize(
+        Vector{subject.x - eye.x, subject.y - eye.y, subject.z - eye.z});
+    side = Normalize(Cross(forward, Vector{0, 1, 0}));
+    up = Cross(side, forward);
+    const double tangent = tan(fov);
+    left = window[0] * tangent * 4 / 3;
+    right = window[1] * tangent * 4 / 3;
+    bottom = window[2] * tangent;
+    top = window[3] * tangent;
+  }
+
+  // How far the sphere is outside the frustum: positive when it's entirely
+  // outside some plane, negative when it's inside all of them by that much.
+  // Sets depth to the distance of its center in front of the camera.
+  double Outside(Vector center, double radius, double& depth) const {
+    const Vector offset{center.x - eye.x, center.y - eye.y, center.z - eye.z};
+    depth = Dot(offset, forward);
+    const double horizontal = Dot(offset, side);
+    const double vertical = Dot(offset, up);
+    double outside = std::max(near - depth, depth - far) - radius;
+    // A point is inside an edge when sideways <= depth * slope; the distance
+    // past that is measured along the edge plane's normal.
+    const double edges[4][2] = {
+      {horizontal, right}, {-horizontal, -left},
+      {vertical, top}, {-vertical, -bottom}};
+    for (auto& edge : edges) {
+      const double distance =
+          (edge[0] - depth * edge[1]) / sqrt(1 + edge[1] * edge[1]);
+      outside = std::max(outside, distance - radius);
+    }
+    return outside;
+  }
+};
+
+double ToDouble(fixed value) {
+  return value.data_ / 4096.0;
+}
+
+fixed ToFixed(double value) {
+  return fixed::FromRaw((s32)lround(value * 4096));
+}
+
+Vec3 ToVec3(Vector v) {
+  return Vec3{ToFixed(v.x), ToFixed(v.y), ToFixed(v.z)};
+}
+
+Vector Snap(Vector v) {
+  return Vector{ToDouble(ToFixed(v.x)), ToDouble(ToFixed(v.y)),
+                ToDouble(ToFixed(v.z))};
+}
+
+struct Error {
+  const char* name;
+  // Past this, the check fails.
+  double tolerance;
+  double worst;
+};
+
+void Measure(Error& error, double difference) {
+  if (difference > error.worst) {
+    error.worst = difference;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  // In world units. A sphere culled while this far inside would pop out of
+  // view; one kept while this far outside just costs a wasted draw.
+  Error culled{"Culled while inside", 1.0 / 16};
+  Error kept{"Kept while outside", 1.0 / 8};
+  Error depth_error{"Depth", 1.0 / 8};
+
+  // The screen windows the strategies draw with, as left, right, bottom, top.
+  const double kWindows[][4] = {
+    {-1, 1, -1, 1}, {-1, 1, 0, 1}, {-1, 0, -1, 1}, {0.5, 1, -1, -0.5}};
+
+  Random random(options.seed);
+  long visible = 0;
+  long tested = 0;
+  for (int i = 0; i < options.cameras; i++) {
+    const Vector subject = Snap(Vector{random.Range(0, 128), random.Range(0, 8),
+                                       random.Range(-128, 0)});
+    const double angle = random.Range(0, 2 * M_PI);
+    const double distance = random.Range(1, 64);
+    const double height = random.Range(0.5, 48);
+    const Vector eye = Snap(Vector{subject.x + cos(angle) * distance,
+                                   subject.y + height,
+                                   subject.z + sin(angle) * distance});
+
+    const Brads fov = Brads::Raw(
+        degreesToAngle(20 + (int)(random.Next() % 40)));
+    const double near = ToDouble(ToFixed(0.1));
+    const double far = i % 3 == 0 ? 256 : random.Range(1, 768);
+    const double (&window)[4] = kWindows[i % 4];
+
+    render::Frustum frustum;
+    frustum.Set(ToVec3(eye), ToVec3(subject), fov, ToFixed(near), ToFixed(far),
+        ScreenWindow{ToFixed(window[0]), ToFixed(window[1]),
+                     ToFixed(window[2]), ToFixed(window[3])});
+    const ReferenceFrustum reference(eye, subject,
+        fov.data_ * 2 * M_PI / DEGREES_IN_CIRCLE, near, far, window);
+
+    for (int s = 0; s < options.spheres; s++) {
+      // Scattered around the subject, out to about as far as a level goes.
+      const double reach = s % 2 ? 16 : 96;
+      const Vector center = Snap(Vector{
+          subject.x + random.Range(-reach, reach),
+          subject.y + random.Range(-reach / 4, reach / 4),
+          subject.z + random.Range(-reach, reach)});
+      const double radius = ToDouble(ToFixed(random.Range(0.25, 8)));
+
+      fixed depth;
+      const bool inside = frustum.TestSphere(ToVec3(center), ToFixed(radius),
+                                             depth);
+      double expected_depth;
+      const double outside = reference.Outside(center, radius, expected_depth);
+      tested++;
+      if (inside) {
+        visible++;
+        Measure(kept, outside);
+        Measure(depth_error, fabs(ToDouble(depth) - expected_depth));
+      } else {
+        Measure(culled, -outside);
+      }
+    }
+  }
+
+  printf("%d cameras, %ld spheres, %ld visible\n", options.cameras, tested,
+         visible);
+  printf("%-30s %12s %12s\n", "Part", "Worst", "Tolerance");
+  bool passed = true;
+  for (const Error* error : {&culled, &kept, &depth_error}) {
+    printf("%-30s %12.6f %12.6f\n", error->name, error->worst,
+           error->tolerance);
+    if (error->worst > error->tolerance) {
+      passed = false;
+    }
+  }
+  printf(passed ? "Within tolerance\n" : "Out of tolerance\n");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#include "load_file.h"
+
+#include <cstdio>
+
+namespace tools {
+
+std::vector<u32> LoadFile(const char* filename, u32& length) {
+  std::vector<u32> words;
+  FILE* file = fopen(filename, "rb");
+  if (file == nullptr) {
+    return words;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  words.resize((size + 3) / 4, 0);
+  if (fread(words.data(), 1, size, file) != (size_t)size) {
+    words.clear();
+  }
+  fclose(file);
+  length = size;
+  return words;
+}
+
+}  // namespace tools
@@ -0,0 +1,17 @@
+#ifndef HOST_TOOLS_LOAD_FILE_H
+#define HOST_TOOLS_LOAD_FILE_H
+
+#include <vector>
+
+#include <nds.h>
+
+namespace tools {
+
+// Reads a whole file into words, the way the game's loaders expect it, with
+// the last word zero padded. Sets length to the size in bytes. Returns an empty
+// vector if the file couldn't be read.
+std::vector<u32> LoadFile(const char* filename, u32& length);
+
+}  // namespace tools
+
+#endif
@@ -0,0 +1,363 @@
+// Runs physics::World headless for a fixed number of ticks, with a seeded
+// crowd of pikmin milling around some obstacles and sensors. Prints how long
+// each physics profiler topic took, and a checksum of every body's final
+// position; the same seed and settings must always produce the same checksum.
+// Every tick also checks a few World::QueryCylinder calls against a brute
+// force scan of every body, and every so often frees a pikmin and hands its
+// slot straight to a new one, which must not inherit the old one's contacts.
+// Exits non-zero if either check fails.
+//
+// Usage: physics_sim [--pikmin=N] [--obstacles=N] [--ticks=N] [--seed=N]
+//                    [--heightmap=file.height]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nds.h>
+
+#include "debug/profiler.h"
+#include "physics/world.h"
+#include "project_settings.h"
+
+using numeric_types::fixed;
+using numeric_types::literals::operator"" _f;
+using physics::Body;
+
+namespace {
+
+// Our own generator, so runs match across C libraries.
+class Random {
+  public:
+    explicit Random(u32 seed) : state_{seed ? seed : 1} {}
+    u32 Next() {
+      state_ ^= state_ << 13;
+      state_ ^= state_ >> 17;
+      state_ ^= state_ << 5;
+      return state_;
+    }
+    // Uniform in [low, high)
+    fixed Range(fixed low, fixed high) {
+      return low + fixed::FromRaw(Next() % (u32)(high - low).data_);
+    }
+  private:
+    u32 state_;
+};
+
+struct Options {
+  int pikmin = 100;
+  int obstacles = 16;
+  int ticks = 600;
+  u32 seed = 1;
+  std::string heightmap;
+};
+
+bool ParseOption(const char* arg, const char* name, std::string& value) {
+  const size_t length = strlen(name);
+  if (strncmp(arg, name, length) == 0 and arg[length] == '=') {
+    value = arg + length + 1;
+    return true;
+  }
+  return false;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string value;
+    if (ParseOption(argv[i], "--pikmin", value)) {
+      options.pikmin = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--obstacles", value)) {
+      options.obstacles = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--ticks", value)) {
+      options.ticks = atoi(value.c_str());
+    } else if (ParseOption(argv[i], "--seed", value)) {
+      options.seed = strtoul(value.c_str(), nullptr, 10);
+    } else if (ParseOption(argv[i], "--heightmap", value)) {
+      options.heightmap = value;
+    } else {
+      fprintf(stderr, "Unrecognized option: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// A flat 64x64 map with no walls, laid out the way image-to-heightmap.py
+// writes it.
+std::vector<u32> FlatHeightmap() {
+  const int kSize = 64;
+  const int cells = kSize * kSize;
+  std::vector<u32> words(2 + (cells * 3 + 3) / 4 + 1, 0);
+  words[0] = kSize;
+  words[1] = kSize;
+  u8* wall_field = (u8*)&words[2] + cells;
+  memset(wall_field, 0xF0, cells);  // Far from any wall, no wall edges
+  return words;
+}
+
+std::vector<u32> LoadHeightmap(const std::string& filename) {
+  std::vector<u32> words;
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (file == nullptr) {
+    return words;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  words.resize((size + 3) / 4 + 1, 0);
+  if (fread(words.data(), 1, size, file) != (size_t)size) {
+    words.clear();
+  }
+  fclose(file);
+  return words;
+}
+
+bool CylindersOverlap(const Vec3& a_position, fixed a_radius, fixed a_height,
+                      const Vec3& b_position, fixed b_radius, fixed b_height) {
+  const fixed dx = a_position.x - b_position.x;
+  const fixed dz = a_position.z - b_position.z;
+  const fixed sum = a_radius + b_radius;
+  return dx * dx + dz * dz < sum * sum and
+         a_position.y + a_height >= b_position.y and
+         b_position.y + b_height >= a_position.y;
+}
+
+// Runs a few queries at random spots, and returns how many of them found a
+// different set of bodies than checking every body would.
+int CheckQueries(physics::World* world, const std::vector<Body*>& bodies,
+                 Random& random, fixed map_width, fixed map_height) {
+  const u32 kGroups[] = {PIKMIN_GROUP, TREASURE_GROUP, DETECT_GROUP,
+                         PIKMIN_GROUP | TREASURE_GROUP};
+  int mismatches = 0;
+  for (int q = 0; q < 4; q++) {
+    const Vec3 center{random.Range(0_f, map_width), -1_f,
+                      random.Range(0_f, map_height)};
+    const fixed radius = random.Range(1_f, 12_f);
+    const u32 group_mask = kGroups[random.Next() % 4];
+
+    Body* found[MAX_PHYSICS_BODIES];
+    const int count = world->QueryCylinder(center, radius, 8_f, group_mask,
+                                           found, MAX_PHYSICS_BODIES);
+    std::vector<Body*> actual(found, found + count);
+    std::vector<Body*> expected;
+    for (Body* body : bodies) {
+      if ((body->collision_group & group_mask) and
+          CylindersOverlap(center, radius, 8_f,
+                           body->position, body->radius, body->height)) {
+        expected.push_back(body);
+      }
+    }
+    std::sort(actual.begin(), actual.end());
+    std::sort(expected.begin(), expected.end());
+    if (actual != expected) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+// Frees a pikmin and allocates a new one, which gets the same slot back, as
+// when a pikmin dies and another spawns on the same step. The new one starts
+// out where the old one was, doing the same thing.
+Body* ReuseSensor(physics::World* world, Body* body) {
+  const Body old = *body;
+  world->FreeBody(body);
+  Body* reused = world->AllocateBody();
+  reused->position = old.position;
+  reused->velocity = old.velocity;
+  reused->radius = old.radius;
+  reused->height = old.height;
+  reused->is_pikmin = old.is_pikmin;
+  reused->is_movable = old.is_movable;
+  reused->collision_group = old.collision_group;
+  reused->sensor_groups = old.sensor_groups;
+  return reused;
+}
+
+// Contacts the body can see that it didn't make itself, or that say they
+// persisted or ended when it has only just been allocated.
+int InheritedContacts(physics::World* world, Body* body) {
+  Handle handle = world->HandleOf(body);
+  int count;
+  const physics::Contact* contacts = world->ContactsFor(body, count);
+  int inherited = 0;
+  for (int i = 0; i < count; i++) {
+    if (not handle.Matches(contacts[i].sensor) or
+        contacts[i].phase != physics::ContactPhase::kBegin) {
+      inherited++;
+    }
+  }
+  return inherited;
+}
+
+u32 Checksum(const std::vector<Body*>& bodies) {
+  // FNV-1a over the raw fixed point positions
+  u32 hash = 2166136261u;
+  for (Body* body : bodies) {
+    const s32 values[3] = {
+        body->position.x.data_, body->position.y.data_, body->position.z.data_};
+    for (s32 value : values) {
+      for (int byte = 0; byte < 4; byte++) {
+        hash ^= (value >> (byte * 8)) & 0xFF;
+        hash *= 16777619u;
+      }
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (not ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  std::vector<u32> heightmap = options.heightmap.empty() ?
+      FlatHeightmap() : LoadHeightmap(options.heightmap);
+  if (heightmap.empty()) {
+    fprintf(stderr, "Couldn't load heightmap: %s\n", options.heightmap.c_str());
+    return 1;
+  }
+
+  physics::World* world = new physics::World();
+  world->SetHeightmap((const u8*)heightmap.data());
+  const fixed map_width = fixed::FromInt(heightmap[0]);
+  const fixed map_height = fixed::FromInt(heightmap[1]);
+
+  Random random(options.seed);
+  std::vector<Body*> bodies;
+  std::vector<Body*> pikmin;
+
+  for (int i = 0; i < options.obstacles; i++) {
+    Body* body = world->AllocateBody();
+    if (body == nullptr) {
+      break;
+    }
+    body->position = Vec3{random.Range(0_f, map_width), 0_f,
+                          random.Range(0_f, map_height)};
+    body->radius = random.Range(1_f, 4_f);
+    body->height = 4_f;
+    if (i % 4 == 0) {
+      // Every so often, something for the pikmin to notice instead
+      body->is_sensor = 1;
+      body->collision_group = DETECT_GROUP;
+      body->radius = body->radius * 2_f;
+    } else {
+      body->is_movable = i % 2;
+      body->collision_group = TREASURE_GROUP;
+    }
+    bodies.push_back(body);
+  }
+
+  for (int i = 0; i < options.pikmin; i++) {
+    Body* body = world->AllocateBody();
+    if (body == nullptr) {
+      fprintf(stderr, "Ran out of bodies after %d pikmin\n", i);
+      break;
+    }
+    body->position = Vec3{random.Range(0_f, map_width), 0_f,
+                          random.Range(0_f, map_height)};
+    body->radius = 1_f;
+    body->height = 2_f;
+    body->is_pikmin = 1;
+    body->is_movable = 1;
+    body->collision_group = PIKMIN_GROUP;
+    body->sensor_groups = DETECT_GROUP | TREASURE_GROUP;
+    bodies.push_back(body);
+    pikmin.push_back(body);
+  }
+
+  // Accumulate per topic timings across the whole run
+  debug::Profiler::StartTimer();
+  auto& topics = debug::Profiler::Topics();
+  std::vector<u64> total(topics.size(), 0);
+  std::vector<u32> worst(topics.size(), 0);
+
+  // Queries draw from their own generator, so they leave the checksum alone.
+  Random query_random(options.seed + 1);
+  int query_mismatches = 0;
+  int inherited_contacts = 0;
+
+  Vec3 target = Vec3{map_width / 2_f, 0_f, map_height / 2_f};
+  for (int tick = 0; tick < options.ticks; tick++) {
+    // The crowd follows a target that hops somewhere new every few seconds,
+    // and a few stragglers wander off on their own.
+    if (tick % 120 == 0) {
+      target = Vec3{random.Range(0_f, map_width), 0_f,
+                    random.Range(0_f, map_height)};
+    }
+    for (Body* body : pikmin) {
+      Vec3 to_target = target - body->position;
+      to_target.y = 0_f;
+      if (random.Next() % 16 == 0) {
+        body->velocity.x = random.Range(-0.5_f, 0.5_f);
+        body->velocity.z = random.Range(-0.5_f, 0.5_f);
+      } else if (to_target.Length2() > 9_f) {
+        to_target = to_target.Normalize() * 0.3_f;
+        body->velocity.x = to_target.x;
+        body->velocity.z = to_target.z;
+      }
+    }
+
+    // Before and after the tick that notices, the new pikmin should only see
+    // contacts it began itself.
+    Body* reused = nullptr;
+    if (tick % 30 == 15 and not pikmin.empty()) {
+      // Preferably one that's sensing something, or there's nothing to leak.
+      Body* freed = pikmin[(tick / 30) % pikmin.size()];
+      for (unsigned int i = 0; i < pikmin.size(); i++) {
+        Body* body = pikmin[(tick / 30 + i) % pikmin.size()];
+        int count;
+        world->ContactsFor(body, count);
+        if (count > 0) {
+          freed = body;
+          break;
+        }
+      }
+      reused = ReuseSensor(world, freed);
+      std::replace(bodies.begin(), bodies.end(), freed, reused);
+      std::replace(pikmin.begin(), pikmin.end(), freed, reused);
+      inherited_contacts += InheritedContacts(world, reused);
+    }
+
+    world->Update();
+    query_mismatches += CheckQueries(world, bodies, query_random, map_width,
+                                     map_height);
+    if (reused) {
+      inherited_contacts += InheritedContacts(world, reused);
+    }
+
+    for (unsigned int t = 0; t < topics.size(); t++) {
+      const u32 delta = topics[t].timing.delta();
+      total[t] += delta;
+      if (delta > worst[t]) {
+        worst[t] = delta;
+      }
+    }
+  }
+
+  printf("%d ticks, %d pikmin, %d other bodies, seed %u\n", options.ticks,
+         (int)pikmin.size(), (int)(bodies.size() - pikmin.size()),
+         options.seed);
+  printf("%-32s %10s %10s\n", "Topic", "Mean us", "Worst us");
+  for (unsigned int t = 0; t < topics.size(); t++) {
+    const double mean = options.ticks ?
+        (double)total[t] / options.ticks : 0.0;
+    printf("%-32s %10.2f %10.2f\n", topics[t].name.c_str(),
+           mean * 1000000.0 / BUS_CLOCK,
+           (double)worst[t] * 1000000.0 / BUS_CLOCK);
+  }
+  printf("Sleeping bodies: %d\n", world->SleepingBodies());
+  printf("Dropped contacts: %d\n", world->DroppedContacts());
+  printf("Mismatched queries: %d\n", query_mismatches);
+  printf("Inherited contacts: %d\n", inherited_contacts);
+  printf("Checksum: %08x\n", Checksum(bodies));
+
+  delete world;
+  return query_mismatches == 0 and inherited_contacts == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#!/usr/local/bin/python
+# -*- coding: utf-8 -*-
+"""
+Blender Impostor Script - Renders an atlas of views of one mesh in a .blend
+  file, for the engine to draw in place of the mesh when it's far away.
+
+The atlas has one column for each view angle, starting from straight in front
+of the mesh and turning the same way as a positive rotation about the DS's Y
+axis, and one row for each animation frame, evenly spaced through the chosen
+action and starting at the top. The engine only draws the atlas for entities
+playing that action, so it has to match IMPOSTOR_ANIMATION in the game. Each square cell frames the mesh's
+bounding sphere with an orthographic camera, so the engine can draw it on a
+quad the size of that sphere.
+
+Usage:
+    blender2impostor.py [options] --mesh=<name> <blend_file>
+
+Options:
+    -h --help            Print this message and exit
+    -v --version         Show version number and exit
+    --mesh=<name>        The mesh (object) to render; everything else is hidden
+    --action=<name>      The armature's action to step through [default: Idle]
+    --angles=<count>     Number of view angles, across [default: 8]
+    --frames=<count>     Number of animation frames, down [default: 4]
+    --cell-size=<px>     Width and height of each view, in pixels [default: 16]
+    --output <png_file>  The name of the rendered atlas. If not provided,
+                         defaults to <name>_impostor.a3i5.png next to the
+                         <blend_file>.
+"""
+
+import sys, os, logging, traceback, math, tempfile
+sys.path.append("/usr/local/lib/python3.4/dist-packages")
+try:
+    from docopt import docopt
+except Exception as e:
+    traceback.print_exc()
+    sys.exit(-1)
+logging.basicConfig(level=logging.WARNING)
+log = logging.getLogger()
+
+try:
+    import bpy
+except ImportError:
+    # Not running under Blender; exec this script using Blender instead.
+    script_name = os.path.realpath(__file__)
+    os.execvp('blender', ['-noaudio', '--background', '--python', script_name,
+        '--'] + sys.argv[1:])
+
+import mathutils
+
+PROCESSING_ERROR = -1
+
+def main():
+    try:
+        arguments = docopt(__doc__, version="0.1", argv=adjust_argv(sys.argv))
+
+        mesh_name = arguments['--mesh']
+        output_filename = (arguments['--output'] if arguments['--output'] else
+            os.path.join(os.path.dirname(arguments['<blend_file>']),
+                mesh_name + '_impostor.a3i5.png'))
+        angles = int(arguments['--angles'])
+        frames = int(arguments['--frames'])
+        cell_size = int(arguments['--cell-size'])
+        action_name = arguments['--action']
+
+        open_blendfile(arguments['<blend_file>'])
+        blender_object = isolate_mesh(mesh_name)
+        action = select_action(action_name)
+        render_atlas(blender_object, action, angles, frames, cell_size,
+            output_filename)
+    except Exception as e:
+        log.error("Something bad happened!")
+        traceback.print_exc()
+        sys.exit(-1)
+
+
+def adjust_argv(args):
+    return args[args.index('--') + 1:] if '--' in args else []
+
+def open_blendfile(filename):
+    try:
+        bpy.ops.wm.open_mainfile(filepath=filename)
+    except RuntimeError as error:
+        log.error("Couldn't open " + filename + ", bailing.")
+        sys.exit(PROCESSING_ERROR)
+
+def isolate_mesh(mesh_name):
+    if mesh_name not in bpy.data.objects:
+        log.error("No mesh named " + mesh_name + ", bailing.")
+        sys.exit(PROCESSING_ERROR)
+    for blend_object in bpy.data.objects:
+        if blend_object.type == "MESH":
+            blend_object.hide_render = blend_object.name != mesh_name
+    return bpy.data.objects[mesh_name]
+
+def select_action(action_name):
+    if len(bpy.data.armatures) != 1 or "Armature" not in bpy.data.objects:
+        return None
+    if action_name not in bpy.data.actions:
+        log.error("No action named " + action_name + ", bailing.")
+        sys.exit(PROCESSING_ERROR)
+    action = bpy.data.actions[action_name]
+    bpy.data.objects["Armature"].animation_data.action = action
+    return action
+
+def frame_numbers(action, frames):
+    if action == None:
+        return [bpy.data.scenes[0].frame_current] * frames
+    start = action.frame_range[0]
+    length = action.frame_range[1] - action.frame_range[0]
+    return [int(start + length * frame / frames) for frame in range(frames)]
+
+def bounding_sphere(blender_object):
+    # Of the mesh as it stands before any action is applied, in world space,
+    # just as the exporter takes it.
+    mesh = blender_object.to_mesh(bpy.data.scenes[0], True, "PREVIEW")
+    points = [blender_object.matrix_world * vertex.co for vertex in mesh.vertices]
+    bpy.data.meshes.remove(mesh)
+    low = mathutils.Vector([min(point[axis] for point in points) for axis in range(3)])
+    high = mathutils.Vector([max(point[axis] for point in points) for axis in range(3)])
+    center = (low + high) / 2
+    radius = max((point - center).length for point in points)
+    return center, radius
+
+def view_direction(angle, angles):
+    # Towards the camera. The DS's +Z is Blender's -Y, and a positive turn
+    # about the DS's Y axis takes +Z towards +X.
+    theta = 2 * math.pi * angle / angles
+    return mathutils.Vector((math.sin(theta), -math.cos(theta), 0))
+
+def setup_scene(cell_size):
+    scene = bpy.data.scenes[0]
+    scene.render.resolution_x = cell_size
+    scene.render.resolution_y = cell_size
+    scene.render.resolution_percentage = 100
+    scene.render.alpha_mode = 'TRANSPARENT'
+    scene.render.image_settings.file_format = 'PNG'
+    scene.render.image_settings.color_mode = 'RGBA'
+
+    camera_data = bpy.data.cameras.new("ImpostorCamera")
+    camera_data.type = 'ORTHO'
+    camera = bpy.data.objects.new("ImpostorCamera", camera_data)
+    scene.objects.link(camera)
+    scene.camera = camera
+
+    if not any(blend_object.type == "LAMP" for blend_object in bpy.data.objects):
+        lamp = bpy.data.objects.new("ImpostorLamp", bpy.data.lamps.new("ImpostorLamp", 'SUN'))
+        lamp.rotation_euler = (math.radians(45), 0, math.radians(45))
+        scene.objects.link(lamp)
+    return scene, camera
+
+def render_cell(scene, camera, center, radius, direction, filename):
+    camera.data.ortho_scale = 2 * radius
+    camera.data.clip_start = radius
+    camera.data.clip_end = radius * 3
+    camera.location = center + direction * radius * 2
+    camera.rotation_euler = (-direction).to_track_quat('-Z', 'Y').to_euler()
+    scene.render.filepath = filename
+    bpy.ops.render.render(write_still=True)
+    image = bpy.data.images.load(filename)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    return pixels
+
+def render_atlas(blender_object, action, angles, frames, cell_size,
+        output_filename):
+    scene, camera = setup_scene(cell_size)
+    width = angles * cell_size
+    height = frames * cell_size
+    atlas = [0.0] * (width * height * 4)
+
+    # The engine frames every cell with the mesh's one bounding sphere, so the
+    # atlas does too.
+    center, radius = bounding_sphere(blender_object)
+    scratch = tempfile.mkdtemp()
+    for row, frame in enumerate(frame_numbers(action, frames)):
+        scene.frame_set(frame)
+        for column in range(angles):
+            cell = render_cell(scene, camera, center, radius,
+                view_direction(column, angles),
+                os.path.join(scratch, "cell_%d_%d.png" % (row, column)))
+            # Blender's images start at the bottom left; the atlas's first row
+            # goes at the top.
+            for y in range(cell_size):
+                atlas_y = height - (row + 1) * cell_size + y
+                start = (atlas_y * width + column * cell_size) * 4
+                atlas[start:start + cell_size * 4] = \
+                    cell[y * cell_size * 4:(y + 1) * cell_size * 4]
+        log.info("Rendered frame %d of %s", frame, blender_object.name)
+
+    image = bpy.data.images.new("ImpostorAtlas", width, height, alpha=True)
+    image.pixels = atlas
+    image.filepath_raw = output_filename
+    image.file_format = 'PNG'
+    image.save()
+
+if __name__ == '__main__':
+    main()
@@ -20,18 +20,174 @@ def main(args):
 
   output += struct.pack("<II", width, height)
 
+  heights = []
   for y in range(0,height):
     for x in range(0,width):
-      r,g,b = pixels[x,y][:3]
-      # Note: Blender exports heightmaps normalized to 0-127 for whatever reason, instead of
-      # from 0-255 as one might expect. This is why our adjusted max here is 127, instead of 255.
-      greyscale_value = min(max(0, int((r + g + b) / 3)), 127)
-      output += struct.pack("<B", greyscale_value)
+      heights.append(height_from_pixel(pixels[x,y]))
+
+  # Optional extra data lives in a folder named after the heightmap, so the
+  # build doesn't mistake it for another heightmap:
+  #   <name>/attributes.png          attributes for the ground
+  #   <name>/layer1.png              a second walkable surface (alpha 0 = none)
+  #   <name>/layer1_attributes.png   attributes for that surface
+  # and so on for layer2, layer3...
+  extras_directory = os.path.splitext(input_filename)[0]
+  attributes = load_attributes(os.path.join(extras_directory, "attributes.png"), width, height)
+  layers = load_layers(extras_directory, width, height)
+
+  for i in range(0, width * height):
+    value = heights[i]
+    if layers[i]:
+      value |= HAS_LAYERS
+    output += struct.pack("<B", value)
+
+  for value in wall_field(heights, attributes, width, height):
+    output += struct.pack("<B", value)
+
+  for value in attributes:
+    output += struct.pack("<B", value)
+
+  # Keep the layer index (u16s) aligned
+  while len(output) % 4 != 0:
+    output += struct.pack("<B", 0)
+
+  layer_data = bytes()
+  layer_index = []
+  for cell_layers in layers:
+    layer_index.append(len(layer_data))
+    if cell_layers:
+      layer_data += struct.pack("<B", len(cell_layers))
+      for (layer_height, layer_attributes) in cell_layers:
+        layer_data += struct.pack("<BB", layer_height, layer_attributes)
+  if len(layer_data) > 0xFFFF:
+    sys.exit("Too many layers in %s; layer data is indexed with 16 bits" % input_filename)
+
+  output += struct.pack("<I", len(layer_data))
+  if len(layer_data) > 0:
+    for offset in layer_index:
+      output += struct.pack("<H", offset)
+    output += layer_data
 
   output_file = open(output_filename, "wb")
   output_file.write(output)
   output_file.close()
 
+def height_from_pixel(pixel):
+  r,g,b = pixel[:3]
+  # Note: Blender exports heightmaps normalized to 0-127 for whatever reason, instead of
+  # from 0-255 as one might expect. This is why our adjusted max here is 127, instead of 255.
+  return min(max(0, int((r + g + b) / 3)), 127)
+
+# Set on a ground height when the cell has extra layers above it.
+HAS_LAYERS = 0x80
+
+# Terrain attributes, one byte per surface. Must match physics/world.h.
+TERRAIN_WATER = 0x1
+TERRAIN_FIRE = 0x2
+TERRAIN_WALL = 0x4
+
+def load_attributes(filename, width, height):
+  """Red marks fire, blue marks water, and green marks walls that can't be
+  walked into no matter their height."""
+  attributes = [0] * (width * height)
+  if not os.path.exists(filename):
+    return attributes
+  pixels = Image.open(filename).convert("RGB").load()
+  for y in range(0,height):
+    for x in range(0,width):
+      r,g,b = pixels[x,y]
+      value = 0
+      if r > 127:
+        value |= TERRAIN_FIRE
+      if g > 127:
+        value |= TERRAIN_WALL
+      if b > 127:
+        value |= TERRAIN_WATER
+      attributes[y * width + x] = value
+  return attributes
+
+def load_layers(directory, width, height):
+  """Per cell, a list of (height, attributes) surfaces above the ground,
+  sorted from lowest to highest."""
+  layers = [[] for i in range(0, width * height)]
+  layer_number = 1
+  while True:
+    filename = os.path.join(directory, "layer%d.png" % layer_number)
+    if not os.path.exists(filename):
+      break
+    pixels = Image.open(filename).convert("RGBA").load()
+    attributes = load_attributes(
+        os.path.join(directory, "layer%d_attributes.png" % layer_number), width, height)
+    for y in range(0,height):
+      for x in range(0,width):
+        if pixels[x,y][3] > 0:
+          layers[y * width + x].append((height_from_pixel(pixels[x,y]), attributes[y * width + x]))
+    layer_number += 1
+  for cell_layers in layers:
+    cell_layers.sort()
+  return layers
+
+# Heights are stored in steps of 32/128 units, so this is physics::World's
+# kWallThreshold (2 units) expressed in heightmap steps.
+WALL_THRESHOLD = 8
+
+# Wall field layout, one byte per tile. Must match physics/world.cpp.
+WALL_POSITIVE_X = 0x1
+WALL_NEGATIVE_X = 0x2
+WALL_POSITIVE_Z = 0x4
+WALL_NEGATIVE_Z = 0x8
+MAX_WALL_DISTANCE = 15
+
+def wall_field(heights, attributes, width, height):
+  """For every tile, which of its edges are walls (the neighbor across is too
+  high to walk up, or marked as a wall) in the low nibble, and the distance in
+  tiles to the nearest tile with a wall edge (saturating at 15) in the high
+  nibble. Only the ground is considered; extra layers never block."""
+  def height_at(x, y):
+    x = min(max(0, x), width - 1)
+    y = min(max(0, y), height - 1)
+    if attributes[y * width + x] & TERRAIN_WALL:
+      return 255
+    return heights[y * width + x]
+
+  edges = [0] * (width * height)
+  for y in range(0,height):
+    for x in range(0,width):
+      here = height_at(x, y)
+      mask = 0
+      if height_at(x + 1, y) - here > WALL_THRESHOLD:
+        mask |= WALL_POSITIVE_X
+      if height_at(x - 1, y) - here > WALL_THRESHOLD:
+        mask |= WALL_NEGATIVE_X
+      if height_at(x, y + 1) - here > WALL_THRESHOLD:
+        mask |= WALL_POSITIVE_Z
+      if height_at(x, y - 1) - here > WALL_THRESHOLD:
+        mask |= WALL_NEGATIVE_Z
+      edges[y * width + x] = mask
+
+  # Breadth first search outwards from every wall tile. Stepping to all eight
+  # neighbors gives the chessboard distance, which never overestimates how
+  # many tile crossings it takes to reach a wall.
+  distance = [MAX_WALL_DISTANCE] * (width * height)
+  frontier = []
+  for i in range(0, width * height):
+    if edges[i]:
+      distance[i] = 0
+      frontier.append(i)
+  for step in range(1, MAX_WALL_DISTANCE):
+    next_frontier = []
+    for i in frontier:
+      x, y = i % width, i // width
+      for ny in range(max(0, y - 1), min(height, y + 2)):
+        for nx in range(max(0, x - 1), min(width, x + 2)):
+          n = ny * width + nx
+          if distance[n] > step:
+            distance[n] = step
+            next_frontier.append(n)
+    frontier = next_frontier
+
+  return [(distance[i] << 4) | edges[i] for i in range(0, width * height)]
+
 def valid_command_line_arguments(args):
     return 2 <= len(args) <= 3
 